@@ -3,6 +3,14 @@
 ######################################################################
 
 QT+=opengl
+CONFIG += thread
+LIBS += -lz
+
+# zstd-compressed models need libzstd; gzip needs only zlib
+packagesExist(libzstd) {
+    DEFINES += HAVE_ZSTD
+    LIBS += -lzstd
+}
 TEMPLATE = app
 TARGET = Assignment_2
 INCLUDEPATH += .
@@ -18,22 +26,68 @@ INCLUDEPATH += .
 HEADERS += ArcBall.h \
            ArcBallWidget.h \
            AttributedObject.h \
+           BakeCommand.h \
+           BakeParameters.h \
+           BakedMapShader.h \
            Cartesian3.h \
+           CompressedInput.h \
+           FrameStats.h \
            Homogeneous4.h \
+           Image.h \
+           ImageWriter.h \
+           MappedFile.h \
            Matrix4.h \
+           MeshBuffers.h \
+           MeshCache.h \
+           MeshLevels.h \
+           Meshlets.h \
+           MeshOrder.h \
+           MeshSimplifier.h \
+           ObjectParser.h \
+           ObjectWriter.h \
            Quaternion.h \
            RenderController.h \
            RenderParameters.h \
+           RenderScene.h \
            RenderWidget.h \
-           RenderWindow.h
+           RenderWindow.h \
+           StreamingBake.h \
+           TextureBaker.h \
+           TriangleBins.h \
+           ViewerBenchmark.h \
+           VisibilityBuffer.h \
+           WeldedMesh.h \
+           WorkStealing.h
 SOURCES += ArcBall.cpp \
            ArcBallWidget.cpp \
            AttributedObject.cpp \
+           BakeCommand.cpp \
+           BakedMapShader.cpp \
            Cartesian3.cpp \
+           CompressedInput.cpp \
+           FrameStats.cpp \
            Homogeneous4.cpp \
+           ImageWriter.cpp \
            main.cpp \
+           MappedFile.cpp \
            Matrix4.cpp \
+           MeshBuffers.cpp \
+           MeshCache.cpp \
+           MeshLevels.cpp \
+           Meshlets.cpp \
+           MeshOrder.cpp \
+           MeshSimplifier.cpp \
+           ObjectParser.cpp \
+           ObjectWriter.cpp \
            Quaternion.cpp \
            RenderController.cpp \
+           RenderScene.cpp \
            RenderWidget.cpp \
-           RenderWindow.cpp
+           RenderWindow.cpp \
+           StreamingBake.cpp \
+           TextureBaker.cpp \
+           TriangleBins.cpp \
+           ViewerBenchmark.cpp \
+           VisibilityBuffer.cpp \
+           WeldedMesh.cpp \
+           WorkStealing.cpp
@@ -29,16 +29,10 @@
 // include the C++ standard libraries we need for the header
 #include <vector>
 #include <iostream>
-#ifdef __APPLE__
-#include <OpenGL/gl.h>
-#else
-#include <GL/gl.h>
-#endif
+#include <string>
 
 // include the unit with Cartesian 3-vectors
 #include "Cartesian3.h"
-// the render parameters
-#include "RenderParameters.h"
 
 // define a macro for "not used" flag
 //#define NO_SUCH_ELEMENT -1
@@ -74,8 +68,6 @@ class AttributedObject
     // corresponding vector of texture coordinates
     std::vector<unsigned int> faceTexCoords;
 
-    std::vector<std::vector<Cartesian3>> uvMap;
-
     // centre of gravity - computed after reading
     Cartesian3 centreOfGravity;
 
@@ -88,21 +80,25 @@ class AttributedObject
     // read routine returns true on success, failure otherwise
     bool ReadObjectStream(std::istream &geometryStream);
 
-    // write routine
-    void WriteObjectStream(std::ostream &geometryStream);
+    // read routine for a named file, which is mapped rather than streamed
+    // and parsed on the given number of threads (0 for one per core)
+    // gzip- or zstd-compressed files are parsed while they are decompressed
+    bool ReadObjectFile(const std::string &fileName, int threads = 0);
 
-    // routine to render
-    void Render(RenderParameters *renderParameters);
+    // read routine for a named file that loads the binary cache beside it
+    // if that is up to date, or reads the file and writes the cache if not
+    bool ReadObjectCached(const std::string &fileName, int threads = 0);
 
-    void print();
+    // read routine for the text of a file already in memory
+    bool ReadObjectText(const char *begin, const char *end, int threads = 0);
 
-    void outputTexture(std::string filename);
+    // computes the centre of gravity and size of the object once it is read
+    void FindCentreOfGravity();
 
-    void outputNormal(std::string filename);
+    // write routine, formatting on the given number of threads (0 for one per core)
+    void WriteObjectStream(std::ostream &geometryStream, int threads = 1);
 
-    void drawTriangle(float x0, float y0,
-                      float x1, float y1,
-                      float x2, float y2);
+    void print();
     }; // class AttributedObject
 
 // end of include guard for AttributedObject
@@ -0,0 +1,473 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  BakeCommand.cpp
+//  ------------------------
+//
+//  The headless bake-only command line.  Every model
+//  named on the command line or in a manifest is baked
+//  in this one process, several at a time.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "BakeCommand.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+
+// POSIX, for creating the output directory and expanding patterns
+#include <glob.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// local includes
+#include "AttributedObject.h"
+#include "CompressedInput.h"
+#include "MeshCache.h"
+#include "MeshOrder.h"
+#include "ObjectWriter.h"
+#include "StreamingBake.h"
+#include "TextureBaker.h"
+#include "WorkStealing.h"
+
+// the directory maps go to unless told otherwise
+#define BAKE_DEFAULT_OUTPUT "output"
+
+// prints the usage message
+static void PrintUsage(const char *programName)
+    { // PrintUsage()
+    std::cout << "Usage: " << programName << " " << BAKE_ONLY_FLAG << " geometry... [options]" << std::endl;
+    std::cout << "  geometry may be a path, a quoted pattern such as 'models/*.obj'," << std::endl;
+    std::cout << "  or " << BAKE_STDIN_PATH << " to stream a model from standard input" << std::endl;
+    std::cout << "  --manifest file         also bake the models listed in a file, one per line" << std::endl;
+    std::cout << "  --jobs count            models to bake at once (default one per core)" << std::endl;
+    std::cout << "  --summary file          write the result for each model as CSV" << std::endl;
+    std::cout << "  --cache on|off          keep a binary " << MESH_CACHE_EXTENSION << " cache beside each model (default on)" << std::endl;
+    std::cout << "  --stream on|off         bake faces as they are read, never holding the whole mesh" << std::endl;
+    std::cout << "  --output directory      where the maps go (default " << BAKE_DEFAULT_OUTPUT << ")" << std::endl;
+    std::cout << "  --size width[xheight]   size of the maps (default " << BAKE_DEFAULT_SIZE << ")" << std::endl;
+    std::cout << "  --channels list         comma-separated maps to bake: texture,normal" << std::endl;
+    std::cout << "  --format ppm|png        file format of the maps (default ppm)" << std::endl;
+    std::cout << "  --threads count         threads to bake each model with (default cores / jobs)" << std::endl;
+    std::cout << "  --order file|uv|object  reorder the faces along a curve before baking (default file)" << std::endl;
+    std::cout << "  --save-mesh on|off      also write the reordered model as <name>_mesh.obj" << std::endl;
+    } // PrintUsage()
+
+// parses a whole string as a non-negative integer, returns false if it isn't one
+bool ParseCount(const char *text, int &value)
+    { // ParseCount()
+    char *end;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if ((end == text) || (*end != '\0') || (errno != 0) || (parsed < 0) || (parsed > 0x7FFFFFFF))
+        return false;
+    value = (int) parsed;
+    return true;
+    } // ParseCount()
+
+// parses "size" or "widthxheight"
+bool ParseSize(const std::string &text, int &width, int &height)
+    { // ParseSize()
+    size_t cross = text.find('x');
+    if (cross == std::string::npos)
+        { // square
+        if (!ParseCount(text.c_str(), width))
+            return false;
+        height = width;
+        return true;
+        } // square
+    return ParseCount(text.substr(0, cross).c_str(), width) && ParseCount(text.substr(cross + 1).c_str(), height);
+    } // ParseSize()
+
+// parses a comma-separated list of channel names
+static bool ParseChannels(const std::string &text, std::vector<BakeChannel> &channels)
+    { // ParseChannels()
+    channels.clear();
+    size_t start = 0;
+    while (start <= text.size())
+        { // per name
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos)
+            comma = text.size();
+        std::string name = text.substr(start, comma - start);
+
+        if (name == TextureBaker::ChannelName(BAKE_CHANNEL_TEXTURE))
+            channels.push_back(BAKE_CHANNEL_TEXTURE);
+        else if (name == TextureBaker::ChannelName(BAKE_CHANNEL_NORMAL))
+            channels.push_back(BAKE_CHANNEL_NORMAL);
+        else
+            return false;
+
+        start = comma + 1;
+        } // per name
+    return true;
+    } // ParseChannels()
+
+// parses the name of a face order
+static bool ParseOrder(const std::string &text, MeshOrder &order)
+    { // ParseOrder()
+    const MeshOrder orders[3] = { MESH_ORDER_FILE, MESH_ORDER_UV, MESH_ORDER_OBJECT };
+    for (int which = 0; which < 3; which++)
+        if (text == MeshOrderName(orders[which]))
+            { // match
+            order = orders[which];
+            return true;
+            } // match
+    return false;
+    } // ParseOrder()
+
+// creates a directory and any missing parents, returns false on failure
+bool MakeDirectory(const std::string &path)
+    { // MakeDirectory()
+    for (size_t stroke = path.find('/', 1); ; stroke = path.find('/', stroke + 1))
+        { // per level
+        std::string prefix = path.substr(0, stroke);
+        if ((mkdir(prefix.c_str(), 0777) != 0) && (errno != EEXIST))
+            return false;
+        if (stroke == std::string::npos)
+            break;
+        } // per level
+    return true;
+    } // MakeDirectory()
+
+// adds the models named by one argument or manifest line
+// patterns with wildcards are expanded, anything else is taken as it is
+static bool AddModels(const std::string &pattern, std::vector<std::string> &filePaths)
+    { // AddModels()
+    if (pattern.find_first_of("*?[") == std::string::npos)
+        { // plain path
+        filePaths.push_back(pattern);
+        return true;
+        } // plain path
+
+    glob_t matches;
+    int status = glob(pattern.c_str(), 0, NULL, &matches);
+    if (status == 0)
+        for (size_t match = 0; match < matches.gl_pathc; match++)
+            filePaths.push_back(matches.gl_pathv[match]);
+    globfree(&matches);
+
+    if (status != 0)
+        std::cout << "No models match " << pattern << std::endl;
+    return (status == 0);
+    } // AddModels()
+
+// adds the models listed in a manifest: one path or pattern per line,
+// ignoring blank lines and lines starting with #
+static bool ReadManifest(const std::string &manifestPath, std::vector<std::string> &filePaths)
+    { // ReadManifest()
+    std::ifstream manifest(manifestPath.c_str());
+    if (!manifest.good())
+        { // no manifest
+        std::cout << "Cannot read manifest " << manifestPath << std::endl;
+        return false;
+        } // no manifest
+
+    std::string line;
+    while (std::getline(manifest, line))
+        { // per line
+        // trim surrounding white space (including a DOS line end)
+        size_t first = line.find_first_not_of(" \t\r");
+        if ((first == std::string::npos) || (line[first] == '#'))
+            continue;
+        line = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+        if (!AddModels(line, filePaths))
+            return false;
+        } // per line
+    return true;
+    } // ReadManifest()
+
+// the label the summary gives an exit status
+static const char *StatusName(int status)
+    { // StatusName()
+    switch (status)
+        { // switch on status
+        case BAKE_EXIT_SUCCESS:
+            return "ok";
+        case BAKE_EXIT_READ_FAILED:
+            return "read failed";
+        case BAKE_EXIT_BAKE_FAILED:
+            return "bake failed";
+        } // switch on status
+    return "unknown";
+    } // StatusName()
+
+// the name a model's maps are written under: its file name without directory or extension,
+// nor any compression extension (or "stdin" for standard input)
+std::string BakeAssetName(const std::string &filePath)
+    { // BakeAssetName()
+    if (filePath == BAKE_STDIN_PATH)
+        return "stdin";
+    size_t strokeIndex = filePath.find_last_of("/\\");
+    std::string fileName = (strokeIndex == std::string::npos) ? filePath : filePath.substr(strokeIndex + 1);
+    fileName = StripCompressionExtension(fileName);
+    return fileName.substr(0, fileName.find_last_of("."));
+    } // BakeAssetName()
+
+// reads one model in the given mode and bakes it to outputDirectory, filling in the result
+// returns the status, one of the BAKE_EXIT_ codes
+int BakeAsset(const std::string &filePath, const std::string &outputDirectory,
+              const BakeParameters &bakeParameters, BakeReadMode readMode, BakeResult &result)
+    { // BakeAsset()
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    result.filePath = filePath;
+    result.triangles = 0;
+    result.readSeconds = result.bakeSeconds = 0.0;
+
+    // standard input can only be streamed
+    if ((readMode == BAKE_READ_STREAM) || (filePath == BAKE_STDIN_PATH))
+        { // streaming
+        // compressed files are decompressed on a thread of their own as they are parsed
+        CompressedInput decompressor;
+        CompressionFormat format = (filePath == BAKE_STDIN_PATH) ? COMPRESSION_NONE : DetectCompression(filePath);
+        FILE *input = NULL;
+        if (filePath == BAKE_STDIN_PATH)
+            input = stdin;
+        else if (format == COMPRESSION_NONE)
+            input = fopen(filePath.c_str(), "rb");
+        else if (decompressor.Open(filePath, format))
+            input = decompressor.file;
+        if (input == NULL)
+            { // open failed
+            std::cout << "Read failed for object " << filePath << std::endl;
+            return result.status = BAKE_EXIT_READ_FAILED;
+            } // open failed
+
+        // reading & baking overlap, so all the time is counted as baking
+        bool inputValid;
+        bool baked = BakeStream(input, bakeParameters, outputDirectory, BakeAssetName(filePath), result.triangles, inputValid);
+        if (format != COMPRESSION_NONE)
+            inputValid = decompressor.Close() && inputValid;
+        else if (input != stdin)
+            fclose(input);
+        result.bakeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!inputValid)
+            { // object read failed
+            std::cout << "Read failed for object " << filePath << std::endl;
+            return result.status = BAKE_EXIT_READ_FAILED;
+            } // object read failed
+        return result.status = (baked ? BAKE_EXIT_SUCCESS : BAKE_EXIT_BAKE_FAILED);
+        } // streaming
+
+    AttributedObject attributedObject;
+
+    // try reading the geometry file, or its cache
+    bool loaded = (readMode == BAKE_READ_CACHED) ? attributedObject.ReadObjectCached(filePath, bakeParameters.threads)
+                                                 : attributedObject.ReadObjectFile(filePath, bakeParameters.threads);
+    if (!loaded)
+        { // object read failed
+        std::cout << "Read failed for object " << filePath << std::endl;
+        return result.status = BAKE_EXIT_READ_FAILED;
+        } // object read failed
+    result.triangles = attributedObject.faceVertices.size() / 3;
+
+    // reordering is part of preparing the model, so it counts as reading
+    ReorderMesh(attributedObject, bakeParameters.order);
+    if (bakeParameters.saveMesh)
+        { // save mesh
+        std::string meshPath = outputDirectory + "/" + BakeAssetName(filePath) + "_mesh.obj";
+        std::ofstream meshStream(meshPath.c_str(), std::ios::binary);
+        if (!WriteObject(attributedObject, meshStream, bakeParameters.threads))
+            { // write failed
+            std::cout << "Write failed for mesh " << meshPath << std::endl;
+            return result.status = BAKE_EXIT_BAKE_FAILED;
+            } // write failed
+        } // save mesh
+
+    std::chrono::steady_clock::time_point read = std::chrono::steady_clock::now();
+    result.readSeconds = std::chrono::duration<double>(read - start).count();
+
+    TextureBaker textureBaker(&attributedObject, &bakeParameters);
+    bool baked = textureBaker.Bake(outputDirectory, BakeAssetName(filePath));
+
+    result.bakeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - read).count();
+    return result.status = (baked ? BAKE_EXIT_SUCCESS : BAKE_EXIT_BAKE_FAILED);
+    } // BakeAsset()
+
+// quotes a field for CSV, doubling any quotes in it, so commas and quotes in paths survive
+std::string CSVField(const std::string &text)
+    { // CSVField()
+    std::string field = "\"";
+    for (size_t character = 0; character < text.size(); character++)
+        { // per character
+        if (text[character] == '"')
+            field += '"';
+        field += text[character];
+        } // per character
+    return field + "\"";
+    } // CSVField()
+
+// writes the per-asset results as CSV, returns false on failure
+static bool WriteSummary(const std::string &summaryPath, const std::vector<BakeResult> &results)
+    { // WriteSummary()
+    std::ofstream summary(summaryPath.c_str());
+    summary << "model,status,triangles,read_seconds,bake_seconds" << std::endl;
+    for (size_t asset = 0; asset < results.size(); asset++)
+        summary << CSVField(results[asset].filePath) << "," << StatusName(results[asset].status) << ","
+                << results[asset].triangles << "," << results[asset].readSeconds << ","
+                << results[asset].bakeSeconds << std::endl;
+    return summary.good();
+    } // WriteSummary()
+
+// runs the bake-only command line on the arguments after the program name (and flag)
+// returns the process exit status
+int BakeCommand(const char *programName, int argc, char **argv)
+    { // BakeCommand()
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    BakeParameters bakeParameters;
+    std::string outputDirectory = BAKE_DEFAULT_OUTPUT;
+    std::string summaryPath;
+    std::vector<std::string> filePaths;
+    int jobs = 0;
+    bool useCache = true, stream = false;
+
+    for (int arg = 0; arg < argc; arg++)
+        { // per argument
+        std::string option = argv[arg];
+
+        // a bare argument is a model, or a pattern matching several
+        if (option.compare(0, 2, "--") != 0)
+            { // model
+            if (!AddModels(option, filePaths))
+                return BAKE_EXIT_USAGE;
+            continue;
+            } // model
+
+        // every option takes a value
+        if (arg + 1 == argc)
+            { // no value
+            std::cout << "Option " << option << " needs a value" << std::endl;
+            PrintUsage(programName);
+            return BAKE_EXIT_USAGE;
+            } // no value
+        std::string value = argv[++arg];
+
+        bool valid = true;
+        if (option == "--output")
+            outputDirectory = value;
+        else if (option == "--size")
+            valid = ParseSize(value, bakeParameters.width, bakeParameters.height);
+        else if (option == "--channels")
+            valid = ParseChannels(value, bakeParameters.channels);
+        else if ((option == "--format") && ((value == "ppm") || (value == "png")))
+            bakeParameters.format = (value == "png") ? BAKE_FORMAT_PNG : BAKE_FORMAT_PPM;
+        else if (option == "--threads")
+            valid = ParseCount(value.c_str(), bakeParameters.threads);
+        else if (option == "--manifest")
+            { // manifest
+            if (!ReadManifest(value, filePaths))
+                return BAKE_EXIT_USAGE;
+            } // manifest
+        else if (option == "--jobs")
+            valid = ParseCount(value.c_str(), jobs);
+        else if (option == "--summary")
+            summaryPath = value;
+        else if ((option == "--cache") && ((value == "on") || (value == "off")))
+            useCache = (value == "on");
+        else if ((option == "--stream") && ((value == "on") || (value == "off")))
+            stream = (value == "on");
+        else if (option == "--order")
+            valid = ParseOrder(value, bakeParameters.order);
+        else if ((option == "--save-mesh") && ((value == "on") || (value == "off")))
+            bakeParameters.saveMesh = (value == "on");
+        else
+            valid = false;
+
+        if (!valid)
+            { // bad option
+            std::cout << "Bad option " << option << " " << value << std::endl;
+            PrintUsage(programName);
+            return BAKE_EXIT_USAGE;
+            } // bad option
+        } // per argument
+
+    if (filePaths.empty())
+        { // no model
+        PrintUsage(programName);
+        return BAKE_EXIT_USAGE;
+        } // no model
+
+    // a streamed model is never whole, so it cannot be reordered
+    if (stream && ((bakeParameters.order != MESH_ORDER_FILE) || bakeParameters.saveMesh))
+        { // stream & reorder
+        std::cout << "Streamed models cannot be reordered or saved" << std::endl;
+        return BAKE_EXIT_USAGE;
+        } // stream & reorder
+
+    // every model writes to the same directory, so their names must differ
+    std::set<std::string> names;
+    for (size_t asset = 0; asset < filePaths.size(); asset++)
+        if (!names.insert(BakeAssetName(filePaths[asset])).second)
+            { // clash
+            std::cout << "More than one model would be baked as " << BakeAssetName(filePaths[asset]) << std::endl;
+            return BAKE_EXIT_USAGE;
+            } // clash
+
+    if (!MakeDirectory(outputDirectory))
+        { // no output
+        std::cout << "Cannot create output directory " << outputDirectory << std::endl;
+        return BAKE_EXIT_BAKE_FAILED;
+        } // no output
+
+    BakeReadMode readMode = stream ? BAKE_READ_STREAM : (useCache ? BAKE_READ_CACHED : BAKE_READ_PARSE);
+
+    // by default, one asset per core; the cores are shared out between the assets
+    // being baked at once, as is the memory budget
+    int assets = (int) filePaths.size();
+    int cores = DefaultThreadCount();
+    if (jobs == 0)
+        jobs = cores;
+    jobs = std::min(jobs, assets);
+    if (bakeParameters.threads == 0)
+        bakeParameters.threads = std::max(1, cores / jobs);
+    bakeParameters.memoryBudget /= jobs;
+
+    // the assets are independent, so the pool just hands them out
+    std::vector<BakeResult> results(assets);
+    std::mutex printMutex;
+    int finished = 0;
+    RunWorkStealing(assets, jobs, [&](int, int asset)
+        { // per asset
+        BakeAsset(filePaths[asset], outputDirectory, bakeParameters, readMode, results[asset]);
+
+        std::lock_guard<std::mutex> lock(printMutex);
+        finished++;
+        if (assets > 1)
+            std::cout << "[" << finished << "/" << assets << "] " << filePaths[asset] << ": "
+                      << StatusName(results[asset].status) << " in "
+                      << (results[asset].readSeconds + results[asset].bakeSeconds) << " s" << std::endl;
+        }); // per asset
+
+    // the run fails with the worst status of any asset
+    int status = BAKE_EXIT_SUCCESS;
+    int succeeded = 0;
+    for (int asset = 0; asset < assets; asset++)
+        { // per asset
+        status = std::max(status, results[asset].status);
+        if (results[asset].status == BAKE_EXIT_SUCCESS)
+            succeeded++;
+        } // per asset
+
+    if (assets > 1)
+        std::cout << "Baked " << succeeded << " of " << assets << " models in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+                  << " s with " << jobs << " jobs of " << bakeParameters.threads << " threads" << std::endl;
+
+    if (!summaryPath.empty() && !WriteSummary(summaryPath, results))
+        { // no summary
+        std::cout << "Write failed for summary " << summaryPath << std::endl;
+        status = std::max(status, BAKE_EXIT_BAKE_FAILED);
+        } // no summary
+
+    return status;
+    } // BakeCommand()
@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  BakeCommand.h
+//  ------------------------
+//
+//  The headless bake-only command line: reads a model,
+//  bakes the requested maps and exits, without ever
+//  starting Qt or creating a GL context.
+//
+//  Models too big to hold in memory, or arriving on a
+//  pipe, can be streamed: baked a batch of faces at a
+//  time as they are parsed.
+//
+//  Many models can be baked in one run, from a list of
+//  paths, wildcard patterns or a manifest file.  The
+//  models are shared out between a fixed number of
+//  jobs, each baking with its share of the cores.
+//
+//  It is reached either through the --bake-only flag
+//  of the viewer or through the separate bake binary
+//  built from BakeOnly.pro, which links no GUI at all.
+//
+///////////////////////////////////////////////////
+
+// include guard for BakeCommand
+#ifndef _BAKE_COMMAND_H
+#define _BAKE_COMMAND_H
+
+#include <cstddef>
+#include <string>
+
+#include "BakeParameters.h"
+
+// exit status of a bake-only run
+#define BAKE_EXIT_SUCCESS 0
+#define BAKE_EXIT_USAGE 1
+#define BAKE_EXIT_READ_FAILED 2
+#define BAKE_EXIT_BAKE_FAILED 3
+
+// the flag that selects bake-only mode in the viewer
+#define BAKE_ONLY_FLAG "--bake-only"
+
+// the outcome of baking one model
+struct BakeResult
+    { // struct BakeResult
+    std::string filePath;
+    // one of the BAKE_EXIT_ codes
+    int status;
+    // size of the model
+    size_t triangles;
+    // wall-clock time spent reading and baking
+    double readSeconds, bakeSeconds;
+    }; // struct BakeResult
+
+// how a model is read
+enum BakeReadMode
+    { // enum BakeReadMode
+    // parse the whole file
+    BAKE_READ_PARSE,
+    // load the binary cache beside the file, making it if need be
+    BAKE_READ_CACHED,
+    // parse and bake a batch of faces at a time, never holding the whole mesh
+    BAKE_READ_STREAM
+    }; // enum BakeReadMode
+
+// the model path that means standard input (which is always streamed)
+#define BAKE_STDIN_PATH "-"
+
+// the name a model's maps are written under: its file name without directory or extension,
+// nor any compression extension (or "stdin" for standard input)
+std::string BakeAssetName(const std::string &filePath);
+
+// creates a directory and any missing parents, returns false on failure
+bool MakeDirectory(const std::string &path);
+
+// parses a whole string as a non-negative integer, returns false if it isn't one
+bool ParseCount(const char *text, int &value);
+
+// parses "size" or "widthxheight", returns false if it is neither
+bool ParseSize(const std::string &text, int &width, int &height);
+
+// quotes a field for CSV, doubling any quotes in it
+std::string CSVField(const std::string &text);
+
+// reads one model in the given mode and bakes it to outputDirectory, filling in the result
+// returns the status, one of the BAKE_EXIT_ codes
+int BakeAsset(const std::string &filePath, const std::string &outputDirectory,
+              const BakeParameters &bakeParameters, BakeReadMode readMode, BakeResult &result);
+
+// runs the bake-only command line on the arguments after the program name (and flag)
+// returns the process exit status
+int BakeCommand(const char *programName, int argc, char **argv);
+
+// end of include guard for BakeCommand
+#endif
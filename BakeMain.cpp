@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  BakeMain.cpp
+//  ------------------------
+//
+//  Entry point of the headless bake binary, which
+//  takes the same arguments as the viewer's
+//  --bake-only mode, with or without the flag.
+//
+///////////////////////////////////////////////////
+
+// system libraries
+#include <cstring>
+
+// local includes
+#include "BakeCommand.h"
+
+// main routine
+int main(int argc, char **argv)
+    { // main()
+    // skip the program name, and the flag if it was given anyway
+    int first = 1;
+    if ((argc > 1) && (strcmp(argv[1], BAKE_ONLY_FLAG) == 0))
+        first = 2;
+    return BakeCommand(argv[0], argc - first, argv + first);
+    } // main()
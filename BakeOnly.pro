@@ -0,0 +1,64 @@
+######################################################################
+# Headless bake binary: no Qt modules, no GL, no window system
+#
+# qmake BakeOnly.pro -o Makefile.BakeOnly
+# make -f Makefile.BakeOnly
+######################################################################
+
+QT -= core gui
+CONFIG += console thread
+CONFIG -= app_bundle qt
+DEFINES += BAKE_ONLY
+LIBS += -lz
+
+# zstd-compressed models need libzstd; gzip needs only zlib
+packagesExist(libzstd) {
+    DEFINES += HAVE_ZSTD
+    LIBS += -lzstd
+}
+TEMPLATE = app
+TARGET = bake
+INCLUDEPATH += .
+OBJECTS_DIR = bake_only
+
+# Input
+HEADERS += AttributedObject.h \
+           BakeCommand.h \
+           BakeParameters.h \
+           Cartesian3.h \
+           CompressedInput.h \
+           Homogeneous4.h \
+           Image.h \
+           ImageWriter.h \
+           MappedFile.h \
+           Matrix4.h \
+           MeshCache.h \
+           MeshOrder.h \
+           ObjectParser.h \
+           ObjectWriter.h \
+           Quaternion.h \
+           RenderParameters.h \
+           StreamingBake.h \
+           TextureBaker.h \
+           TriangleBins.h \
+           VisibilityBuffer.h \
+           WorkStealing.h
+SOURCES += AttributedObject.cpp \
+           BakeCommand.cpp \
+           BakeMain.cpp \
+           Cartesian3.cpp \
+           CompressedInput.cpp \
+           Homogeneous4.cpp \
+           ImageWriter.cpp \
+           MappedFile.cpp \
+           Matrix4.cpp \
+           MeshCache.cpp \
+           MeshOrder.cpp \
+           ObjectParser.cpp \
+           ObjectWriter.cpp \
+           Quaternion.cpp \
+           StreamingBake.cpp \
+           TextureBaker.cpp \
+           TriangleBins.cpp \
+           VisibilityBuffer.cpp \
+           WorkStealing.cpp
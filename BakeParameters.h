@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////
+//
+//  -----------------------------
+//  Bake Parameters
+//  -----------------------------
+//
+//  The settings for baking an object's attributes into
+//  texture maps, kept separate from the object in the
+//  same way as the render parameters
+//
+/////////////////////////////////////////////////////////////////
+
+// include guard
+#ifndef _BAKE_PARAMETERS_H
+#define _BAKE_PARAMETERS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "MeshOrder.h"
+
+// define some macros for bounds on parameters
+#define BAKE_DEFAULT_SIZE 1024
+#define BAKE_SIZE_MIN 1
+#define BAKE_SIZE_MAX 32768
+
+// the maps are rasterized in square tiles of this many texels
+#define BAKE_TILE_SIZE 64
+
+// 4 GiB is enough for two 16k x 16k maps
+#define BAKE_DEFAULT_MEMORY_BUDGET ((size_t) 4 << 30)
+
+// the maps that can be baked
+enum BakeChannel
+    { // enum BakeChannel
+    BAKE_CHANNEL_TEXTURE,
+    BAKE_CHANNEL_NORMAL
+    }; // enum BakeChannel
+
+// the file formats the maps can be written in
+enum BakeFormat
+    { // enum BakeFormat
+    BAKE_FORMAT_PPM,
+    BAKE_FORMAT_PNG
+    }; // enum BakeFormat
+
+// class for the bake parameters
+class BakeParameters
+    { // class BakeParameters
+    public:
+
+    // size of the baked maps in texels
+    int width, height;
+
+    // the maps to produce
+    std::vector<BakeChannel> channels;
+
+    // and the format to write them in
+    BakeFormat format;
+
+    // the most memory a single bake may allocate, in bytes
+    size_t memoryBudget;
+
+    // number of threads to bake with, 0 for one per core
+    int threads;
+
+    // the order the faces are put in before baking
+    MeshOrder order;
+
+    // whether the reordered mesh is written out beside the maps
+    bool saveMesh;
+
+    // constructor
+    BakeParameters()
+        :
+        width(BAKE_DEFAULT_SIZE),
+        height(BAKE_DEFAULT_SIZE),
+        format(BAKE_FORMAT_PPM),
+        memoryBudget(BAKE_DEFAULT_MEMORY_BUDGET),
+        threads(0),
+        order(MESH_ORDER_FILE),
+        saveMesh(false)
+        { // constructor
+        channels.push_back(BAKE_CHANNEL_TEXTURE);
+        channels.push_back(BAKE_CHANNEL_NORMAL);
+        } // constructor
+
+    }; // class BakeParameters
+
+// end of include guard
+#endif
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  BakedMapShader.cpp
+//  ------------------------
+//
+//  Shows an object through its baked maps, with the
+//  lighting worked out per pixel from the normal map.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "BakedMapShader.h"
+
+// include the C++ standard libraries we want
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// passes the texture coordinates through, using the fixed-function matrices
+static const char *vertexSource =
+    "#version 120\n"
+    "varying vec2 texCoord;\n"
+    "void main()\n"
+    "    {\n"
+    "    texCoord = gl_MultiTexCoord0.xy;\n"
+    "    gl_Position = ftransform();\n"
+    "    }\n";
+
+// diffuse & specular lighting from a light over the viewer's shoulder,
+// with the normal read from the map and rotated into eye space
+static const char *fragmentSource =
+    "#version 120\n"
+    "uniform sampler2D textureMap;\n"
+    "uniform sampler2D normalMap;\n"
+    "varying vec2 texCoord;\n"
+    "void main()\n"
+    "    {\n"
+    "    vec3 colour = texture2D(textureMap, texCoord).rgb;\n"
+    "    vec3 normal = normalize(gl_NormalMatrix * (texture2D(normalMap, texCoord).rgb * 2.0 - 1.0));\n"
+    "    vec3 light = normalize(vec3(0.3, 0.5, 1.0));\n"
+    "    vec3 halfway = normalize(light + vec3(0.0, 0.0, 1.0));\n"
+    "    float diffuse = max(dot(normal, light), 0.0);\n"
+    "    float specular = pow(max(dot(normal, halfway), 0.0), 32.0);\n"
+    "    gl_FragColor = vec4(colour * (0.25 + 0.75 * diffuse) + vec3(0.2 * specular), 1.0);\n"
+    "    }\n";
+
+// constructor creates nothing, as there is no context yet
+BakedMapShader::BakedMapShader()
+    : ready(false)
+    { // BakedMapShader()
+    textures[0] = textures[1] = 0;
+    } // BakedMapShader()
+
+// uploads one map, flipped so that v = 0 is the bottom row as GL expects
+// returns false if the map is larger than GL allows
+bool BakedMapShader::UploadMap(const Image<RGB8> &map, GLuint texture)
+    { // UploadMap()
+    GLint maximumSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maximumSize);
+    if ((map.width > maximumSize) || (map.height > maximumSize))
+        { // too large
+        std::cout << "Baked maps of " << map.width << "x" << map.height << " exceed the largest texture ("
+                  << maximumSize << ")" << std::endl;
+        return false;
+        } // too large
+
+    // the image rows are padded, so they are packed (and flipped) first
+    size_t rowBytes = (size_t) map.width * sizeof(RGB8);
+    std::vector<unsigned char> packed(rowBytes * map.height);
+    for (int y = 0; y < map.height; y++)
+        memcpy(&packed[(map.height - 1 - y) * rowBytes], map.Row(y), rowBytes);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, map.width, map.height, 0, GL_RGB, GL_UNSIGNED_BYTE, &packed[0]);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+    } // UploadMap()
+
+// compiles the shader and uploads both maps as textures
+bool BakedMapShader::Create(const Image<RGB8> *textureMap, const Image<RGB8> *normalMap)
+    { // Create()
+    initializeOpenGLFunctions();
+    ready = false;
+    if ((textureMap == NULL) || (normalMap == NULL))
+        return false;
+
+    if (!program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertexSource)
+        || !program.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentSource)
+        || !program.link())
+        { // shader failed
+        std::cout << "Baked map shader failed: " << program.log().toStdString() << std::endl;
+        return false;
+        } // shader failed
+
+    glGenTextures(2, textures);
+    if (!UploadMap(*textureMap, textures[0]) || !UploadMap(*normalMap, textures[1]))
+        return false;
+
+    // the samplers never change units, so they are set once
+    program.bind();
+    program.setUniformValue("textureMap", 0);
+    program.setUniformValue("normalMap", 1);
+    program.release();
+
+    ready = true;
+    return true;
+    } // Create()
+
+// binds the shader & textures for drawing
+void BakedMapShader::Bind()
+    { // Bind()
+    program.bind();
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    } // Bind()
+
+// releases the shader & textures after drawing
+void BakedMapShader::Release()
+    { // Release()
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    program.release();
+    } // Release()
+
+// frees the shader & textures
+void BakedMapShader::Destroy()
+    { // Destroy()
+    if (textures[0] != 0)
+        glDeleteTextures(2, textures);
+    textures[0] = textures[1] = 0;
+    program.removeAllShaders();
+    ready = false;
+    } // Destroy()
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  BakedMapShader.h
+//  ------------------------
+//
+//  Shows an object through its baked maps rather than
+//  its vertex colours: the colour comes from the
+//  texture map, and the lighting is worked out per
+//  pixel from the normal map, so a coarse mesh shows
+//  the detail baked into its maps.
+//
+//  The normal map holds object-space normals, so the
+//  shader only has to rotate them into eye space.  It
+//  is written against GLSL 1.20 and the fixed-function
+//  matrices, so that it runs on Mesa's llvmpipe.
+//
+///////////////////////////////////////////////////
+
+// include guard for BakedMapShader
+#ifndef _BAKED_MAP_SHADER_H
+#define _BAKED_MAP_SHADER_H
+
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+
+#include "Image.h"
+
+class BakedMapShader : protected QOpenGLFunctions
+    { // class BakedMapShader
+    public:
+    // constructor creates nothing, as there is no context yet
+    BakedMapShader();
+
+    // compiles the shader and uploads both maps as textures
+    // the widget's context must be current
+    // returns false (and leaves the shader unusable) if either map
+    // is missing or too large, or the shader does not compile
+    bool Create(const Image<RGB8> *textureMap, const Image<RGB8> *normalMap);
+
+    // whether Create() succeeded
+    bool IsReady() const
+        { return ready; }
+
+    // binds the shader & textures for drawing, then releases them again
+    void Bind();
+    void Release();
+
+    // frees the shader & textures; the widget's context must be current
+    void Destroy();
+
+    private:
+    QOpenGLShaderProgram program;
+
+    // the texture & normal maps
+    GLuint textures[2];
+
+    // whether everything was created
+    bool ready;
+
+    // uploads one map, flipped so that v = 0 is the bottom row as GL expects
+    // returns false if the map is larger than GL allows
+    bool UploadMap(const Image<RGB8> &map, GLuint texture);
+    }; // class BakedMapShader
+
+// end of include guard for BakedMapShader
+#endif
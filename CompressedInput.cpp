@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  CompressedInput.cpp
+//  ------------------------
+//
+//  Reads gzip- or zstd-compressed files as if they were
+//  plain text.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "CompressedInput.h"
+
+// include the C++ standard libraries we want
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// POSIX sockets, for passing the text to the reader
+#include <sys/socket.h>
+#include <unistd.h>
+
+// the decompressors
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// compressed data are read in blocks of this size
+#define DECOMPRESS_BLOCK_SIZE (1 << 20)
+
+// tells the compression of a file from its first bytes
+CompressionFormat DetectCompression(const char *data, size_t size)
+    { // DetectCompression()
+    const unsigned char *bytes = (const unsigned char *) data;
+    if ((size >= 2) && (bytes[0] == 0x1F) && (bytes[1] == 0x8B))
+        return COMPRESSION_GZIP;
+    if ((size >= 4) && (bytes[0] == 0x28) && (bytes[1] == 0xB5) && (bytes[2] == 0x2F) && (bytes[3] == 0xFD))
+        return COMPRESSION_ZSTD;
+    return COMPRESSION_NONE;
+    } // DetectCompression()
+
+// tells the compression of a named file from its first bytes
+// (a file that cannot be read counts as uncompressed)
+CompressionFormat DetectCompression(const std::string &fileName)
+    { // DetectCompression()
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file == NULL)
+        return COMPRESSION_NONE;
+    char magic[4];
+    size_t size = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return DetectCompression(magic, size);
+    } // DetectCompression()
+
+// strips a .gz or .zst extension from a file name, if it has one
+std::string StripCompressionExtension(const std::string &fileName)
+    { // StripCompressionExtension()
+    static const char *extensions[2] = { ".gz", ".zst" };
+    for (int extension = 0; extension < 2; extension++)
+        { // per extension
+        size_t length = strlen(extensions[extension]);
+        if ((fileName.size() > length) && (fileName.compare(fileName.size() - length, length, extensions[extension]) == 0))
+            return fileName.substr(0, fileName.size() - length);
+        } // per extension
+    return fileName;
+    } // StripCompressionExtension()
+
+// constructor opens nothing
+CompressedInput::CompressedInput()
+    : file(NULL), source(NULL), writeEnd(-1), format(COMPRESSION_NONE), succeeded(false)
+    { // CompressedInput()
+    } // CompressedInput()
+
+// closes the input if it is still open
+CompressedInput::~CompressedInput()
+    { // ~CompressedInput()
+    Close();
+    } // ~CompressedInput()
+
+// starts decompressing the named file on a thread of its own
+// returns false if it cannot be opened, or the format is not supported
+bool CompressedInput::Open(const std::string &fileName, CompressionFormat newFormat)
+    { // Open()
+    Close();
+    format = newFormat;
+#ifndef HAVE_ZSTD
+    if (format == COMPRESSION_ZSTD)
+        { // no zstd
+        std::cout << "This build cannot read zstd-compressed files" << std::endl;
+        return false;
+        } // no zstd
+#endif
+    if (format == COMPRESSION_NONE)
+        return false;
+
+    source = fopen(fileName.c_str(), "rb");
+    if (source == NULL)
+        return false;
+
+    // a socket rather than a pipe, so that a reader that stops early
+    // gives the thread an error instead of a SIGPIPE
+    int ends[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0)
+        { // no socket
+        fclose(source);
+        source = NULL;
+        return false;
+        } // no socket
+    writeEnd = ends[1];
+    file = fdopen(ends[0], "rb");
+    if (file == NULL)
+        { // no stream
+        close(ends[0]);
+        close(ends[1]);
+        fclose(source);
+        source = NULL;
+        writeEnd = -1;
+        return false;
+        } // no stream
+
+    succeeded = false;
+    thread = std::thread(&CompressedInput::Decompress, this);
+    return true;
+    } // Open()
+
+// stops reading and waits for the thread
+// returns false if the compressed data could not be read or were corrupt
+bool CompressedInput::Close()
+    { // Close()
+    // closing our end first makes the thread give up if we stopped early
+    if (file != NULL)
+        fclose(file);
+    file = NULL;
+    if (thread.joinable())
+        thread.join();
+    if (source != NULL)
+        fclose(source);
+    source = NULL;
+    return succeeded;
+    } // Close()
+
+// sends a block of text to the reader, returns false if the reader has gone
+bool CompressedInput::Send(const char *data, size_t size)
+    { // Send()
+    while (size > 0)
+        { // until all sent
+        ssize_t sent = send(writeEnd, data, size, MSG_NOSIGNAL);
+        if (sent < 0)
+            { // error
+            if (errno == EINTR)
+                continue;
+            return false;
+            } // error
+        data += sent;
+        size -= sent;
+        } // until all sent
+    return true;
+    } // Send()
+
+// the body of the thread
+void CompressedInput::Decompress()
+    { // Decompress()
+    std::vector<unsigned char> input(DECOMPRESS_BLOCK_SIZE), output(DECOMPRESS_BLOCK_SIZE);
+    bool ok = true, finished = false;
+
+    if (format == COMPRESSION_GZIP)
+        { // gzip
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        // 15 + 32: the largest window, with the gzip or zlib header detected
+        ok = (inflateInit2(&stream, 15 + 32) == Z_OK);
+        while (ok)
+            { // per block read
+            stream.avail_in = (uInt) fread(&input[0], 1, input.size(), source);
+            stream.next_in = &input[0];
+            if (stream.avail_in == 0)
+                break;
+            while (ok && (stream.avail_in > 0))
+                { // until the block is used
+                stream.next_out = &output[0];
+                stream.avail_out = (uInt) output.size();
+                int status = inflate(&stream, Z_NO_FLUSH);
+                ok = ((status == Z_OK) || (status == Z_STREAM_END) || (status == Z_BUF_ERROR))
+                    && Send((const char *) &output[0], output.size() - stream.avail_out);
+                finished = (status == Z_STREAM_END);
+                // gzip files may hold several members one after another
+                if (finished && (stream.avail_in > 0))
+                    ok = ok && (inflateReset(&stream) == Z_OK);
+                } // until the block is used
+            // the member may end exactly at the end of a block
+            if (finished)
+                ok = ok && (inflateReset(&stream) == Z_OK);
+            } // per block read
+        inflateEnd(&stream);
+        } // gzip
+#ifdef HAVE_ZSTD
+    else if (format == COMPRESSION_ZSTD)
+        { // zstd
+        ZSTD_DStream *stream = ZSTD_createDStream();
+        ok = (stream != NULL) && !ZSTD_isError(ZSTD_initDStream(stream));
+        size_t hint = 0;
+        while (ok)
+            { // per block read
+            ZSTD_inBuffer in = { &input[0], fread(&input[0], 1, input.size(), source), 0 };
+            if (in.size == 0)
+                break;
+            while (ok && (in.pos < in.size))
+                { // until the block is used
+                ZSTD_outBuffer out = { &output[0], output.size(), 0 };
+                hint = ZSTD_decompressStream(stream, &out, &in);
+                ok = !ZSTD_isError(hint) && Send((const char *) &output[0], out.pos);
+                } // until the block is used
+            } // per block read
+        // a hint of 0 means the last frame was complete
+        finished = ok && (hint == 0);
+        ZSTD_freeDStream(stream);
+        } // zstd
+#endif
+
+    // a truncated file stops mid-stream
+    succeeded = ok && finished && !ferror(source);
+
+    // closing our end tells the reader the text is over
+    close(writeEnd);
+    writeEnd = -1;
+    } // Decompress()
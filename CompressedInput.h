@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  CompressedInput.h
+//  ------------------------
+//
+//  Reads gzip- or zstd-compressed files as if they were
+//  plain text, so that compressed models can be loaded
+//  without first unpacking them to disk.
+//
+//  The file is decompressed on a thread of its own and
+//  the text is passed to the reader through a local
+//  socket, so decompression overlaps with parsing and
+//  the reader sees an ordinary FILE.
+//
+//  zstd support needs libzstd at build time (HAVE_ZSTD),
+//  gzip support only needs zlib.
+//
+///////////////////////////////////////////////////
+
+// include guard for CompressedInput
+#ifndef _COMPRESSED_INPUT_H
+#define _COMPRESSED_INPUT_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+// the ways a file may be compressed
+enum CompressionFormat
+    { // enum CompressionFormat
+    COMPRESSION_NONE,
+    COMPRESSION_GZIP,
+    COMPRESSION_ZSTD
+    }; // enum CompressionFormat
+
+// tells the compression of a file from its first bytes
+CompressionFormat DetectCompression(const char *data, size_t size);
+
+// tells the compression of a named file from its first bytes
+// (a file that cannot be read counts as uncompressed)
+CompressionFormat DetectCompression(const std::string &fileName);
+
+// strips a .gz or .zst extension from a file name, if it has one
+std::string StripCompressionExtension(const std::string &fileName);
+
+class CompressedInput
+    { // class CompressedInput
+    public:
+    // the decompressed text, to be read like any other file
+    // NULL until the input is opened
+    FILE *file;
+
+    // constructor opens nothing
+    CompressedInput();
+
+    // closes the input if it is still open
+    ~CompressedInput();
+
+    // starts decompressing the named file on a thread of its own
+    // returns false if it cannot be opened, or the format is not supported
+    bool Open(const std::string &fileName, CompressionFormat format);
+
+    // stops reading and waits for the thread
+    // returns false if the compressed data could not be read or were corrupt
+    bool Close();
+
+    private:
+    // the compressed file, and the end of the socket the thread writes to
+    FILE *source;
+    int writeEnd;
+    CompressionFormat format;
+
+    // the thread, and whether it decompressed everything
+    std::thread thread;
+    bool succeeded;
+
+    // the body of the thread
+    void Decompress();
+
+    // sends a block of text to the reader, returns false if the reader has gone
+    bool Send(const char *data, size_t size);
+
+    // an input cannot be shared
+    CompressedInput(const CompressedInput &);
+    CompressedInput &operator = (const CompressedInput &);
+    }; // class CompressedInput
+
+// end of include guard for CompressedInput
+#endif
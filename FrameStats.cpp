@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  FrameStats.cpp
+//  ------------------------
+//
+//  Keeps the timings of the viewer's most recent
+//  frames.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "FrameStats.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cstdio>
+
+// constructor keeps no frames
+FrameStats::FrameStats()
+    : samples(FRAME_STATS_SAMPLES),
+    frameCount(0)
+    { // FrameStats()
+    } // FrameStats()
+
+// adds a frame, dropping the oldest if full
+unsigned long FrameStats::Record(const FrameSample &sample)
+    { // Record()
+    samples[frameCount % FRAME_STATS_SAMPLES] = sample;
+    return frameCount++;
+    } // Record()
+
+// fills in a frame's GPU time, if the frame is still kept
+void FrameStats::RecordGPUTime(unsigned long frame, float milliseconds)
+    { // RecordGPUTime()
+    if ((frame < frameCount) && (frameCount - frame <= FRAME_STATS_SAMPLES))
+        samples[frame % FRAME_STATS_SAMPLES].gpuMilliseconds = milliseconds;
+    } // RecordGPUTime()
+
+// how many frames are kept
+size_t FrameStats::Count() const
+    { // Count()
+    return std::min(frameCount, (unsigned long) FRAME_STATS_SAMPLES);
+    } // Count()
+
+// each kept frame, oldest first
+const FrameSample &FrameStats::Sample(size_t index) const
+    { // Sample()
+    return samples[(frameCount - Count() + index) % FRAME_STATS_SAMPLES];
+    } // Sample()
+
+// how many of the kept frames started in the second before the newest
+int FrameStats::RedrawsPerSecond() const
+    { // RedrawsPerSecond()
+    size_t count = Count();
+    if (count == 0)
+        return 0;
+    double newest = Sample(count - 1).time;
+    int redraws = 0;
+    for (size_t index = count; (index-- > 0) && (Sample(index).time > newest - 1.0); )
+        redraws++;
+    return redraws;
+    } // RedrawsPerSecond()
+
+// the given percentile (0 to 100) of paintGL times
+float FrameStats::PaintPercentile(float percentile) const
+    { // PaintPercentile()
+    size_t count = Count();
+    if (count == 0)
+        return 0.0f;
+    std::vector<float> times(count);
+    for (size_t index = 0; index < count; index++)
+        times[index] = Sample(index).paintMilliseconds;
+    size_t rank = std::min(count - 1, (size_t) (percentile / 100.0f * count));
+    std::nth_element(times.begin(), times.begin() + rank, times.end());
+    return times[rank];
+    } // PaintPercentile()
+
+// counts paintGL times into FRAME_STATS_BINS bins
+void FrameStats::Histogram(std::vector<int> &bins) const
+    { // Histogram()
+    bins.assign(FRAME_STATS_BINS, 0);
+    for (size_t index = 0; index < Count(); index++)
+        { // per frame
+        int bin = (int) (Sample(index).paintMilliseconds / FRAME_STATS_BIN_MILLISECONDS);
+        bins[std::max(0, std::min(bin, FRAME_STATS_BINS - 1))]++;
+        } // per frame
+    } // Histogram()
+
+// writes every kept frame as a line of CSV
+bool FrameStats::WriteCSV(const std::string &fileName) const
+    { // WriteCSV()
+    FILE *file = fopen(fileName.c_str(), "w");
+    if (file == NULL)
+        return false;
+
+    fprintf(file, "frame,time,paint_ms,draw_ms,gpu_ms,latency_ms,triangles,level\n");
+    unsigned long first = frameCount - Count();
+    for (size_t index = 0; index < Count(); index++)
+        { // per frame
+        const FrameSample &sample = Sample(index);
+        fprintf(file, "%lu,%.6f,%.3f,%.3f,%.3f,%.3f,%lu,%d\n", first + index, sample.time,
+                sample.paintMilliseconds, sample.drawMilliseconds, sample.gpuMilliseconds,
+                sample.latencyMilliseconds, (unsigned long) sample.triangles, sample.level);
+        } // per frame
+
+    return fclose(file) == 0;
+    } // WriteCSV()
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  FrameStats.h
+//  ------------------------
+//
+//  Keeps the timings of the viewer's most recent
+//  frames, so that they can be shown as a histogram
+//  over the scene or written out as CSV.
+//
+//  Each frame records the CPU time of the whole of
+//  paintGL and of the draw call within it, the time
+//  since the input that asked for it, and how many
+//  triangles it drew.  GPU times come from timer
+//  queries, whose results arrive a few frames late,
+//  so they are filled in afterwards by frame number.
+//
+///////////////////////////////////////////////////
+
+// include guard for FrameStats
+#ifndef _FRAME_STATS_H
+#define _FRAME_STATS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// how many frames are kept
+#define FRAME_STATS_SAMPLES 512
+
+// the histogram has bins this wide, the last catching everything slower
+#define FRAME_STATS_BIN_MILLISECONDS 2.0f
+#define FRAME_STATS_BINS 25
+
+// one frame; times that were not measured are negative
+struct FrameSample
+    { // struct FrameSample
+    // when the frame started, in seconds since the first frame
+    double time;
+
+    // CPU time of paintGL and of the draw call, GPU time of the draw call
+    float paintMilliseconds, drawMilliseconds, gpuMilliseconds;
+
+    // time from the mouse event that asked for the frame to the frame
+    float latencyMilliseconds;
+
+    // what was drawn
+    size_t triangles;
+    int level;
+    }; // struct FrameSample
+
+class FrameStats
+    { // class FrameStats
+    public:
+    // constructor keeps no frames
+    FrameStats();
+
+    // adds a frame, dropping the oldest if full
+    // returns the frame's number, for RecordGPUTime
+    unsigned long Record(const FrameSample &sample);
+
+    // fills in a frame's GPU time, if the frame is still kept
+    void RecordGPUTime(unsigned long frame, float milliseconds);
+
+    // how many frames are kept, and each of them, oldest first
+    size_t Count() const;
+    const FrameSample &Sample(size_t index) const;
+
+    // how many of the kept frames started in the second before the newest
+    int RedrawsPerSecond() const;
+
+    // the given percentile (0 to 100) of paintGL times
+    float PaintPercentile(float percentile) const;
+
+    // counts paintGL times into FRAME_STATS_BINS bins
+    void Histogram(std::vector<int> &bins) const;
+
+    // writes every kept frame as a line of CSV
+    // returns true on success, false otherwise
+    bool WriteCSV(const std::string &fileName) const;
+
+    private:
+    // a ring of frames, with frameCount recorded in all
+    std::vector<FrameSample> samples;
+    unsigned long frameCount;
+    }; // class FrameStats
+
+// end of include guard for FrameStats
+#endif
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  Image.h
+//  ------------------------
+//
+//  A minimal 2D image: one aligned allocation,
+//  row-major with a stride, templated on the pixel
+//  format so that the same code serves 8-bit, 16-bit
+//  and float maps as well as non-colour buffers.
+//
+///////////////////////////////////////////////////
+
+// include guard for Image
+#ifndef _IMAGE_H
+#define _IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// rows start on a cache line boundary
+#define IMAGE_ROW_ALIGNMENT 64
+
+// pixel formats: each converts from RGB components in the unit interval
+struct RGB8
+    { // struct RGB8
+    unsigned char r, g, b;
+    static float MaxValue() { return 255.0f; }
+    static RGB8 FromUnit(float r, float g, float b);
+    }; // struct RGB8
+
+struct RGB16
+    { // struct RGB16
+    unsigned short r, g, b;
+    static float MaxValue() { return 65535.0f; }
+    static RGB16 FromUnit(float r, float g, float b);
+    }; // struct RGB16
+
+struct RGBF32
+    { // struct RGBF32
+    float r, g, b;
+    static float MaxValue() { return 1.0f; }
+    static RGBF32 FromUnit(float r, float g, float b);
+    }; // struct RGBF32
+
+// clamps a unit interval value and scales it to an integer range
+inline unsigned int QuantizeUnit(float value, float maxValue)
+    { // QuantizeUnit()
+    if (!(value > 0.0f))
+        return 0;
+    if (value >= 1.0f)
+        return (unsigned int) maxValue;
+    return (unsigned int) (value * maxValue + 0.5f);
+    } // QuantizeUnit()
+
+inline RGB8 RGB8::FromUnit(float r, float g, float b)
+    { // RGB8::FromUnit()
+    RGB8 pixel = { (unsigned char) QuantizeUnit(r, MaxValue()),
+                   (unsigned char) QuantizeUnit(g, MaxValue()),
+                   (unsigned char) QuantizeUnit(b, MaxValue()) };
+    return pixel;
+    } // RGB8::FromUnit()
+
+inline RGB16 RGB16::FromUnit(float r, float g, float b)
+    { // RGB16::FromUnit()
+    RGB16 pixel = { (unsigned short) QuantizeUnit(r, MaxValue()),
+                    (unsigned short) QuantizeUnit(g, MaxValue()),
+                    (unsigned short) QuantizeUnit(b, MaxValue()) };
+    return pixel;
+    } // RGB16::FromUnit()
+
+inline RGBF32 RGBF32::FromUnit(float r, float g, float b)
+    { // RGBF32::FromUnit()
+    RGBF32 pixel = { r, g, b };
+    return pixel;
+    } // RGBF32::FromUnit()
+
+template <class Pixel>
+class Image
+    { // class Image
+    public:
+    // size in pixels
+    int width, height;
+
+    // distance in bytes from the start of one row to the next
+    size_t stride;
+
+    // constructor allocates the image and fills it with a single value
+    Image(int newWidth, int newHeight, const Pixel &fill = Pixel())
+        : width(newWidth), height(newHeight),
+        stride(RowBytes(newWidth)),
+        allocation(NULL), pixels(NULL)
+        { // Image()
+        // over-allocate so we can align the first row
+        allocation = new unsigned char[stride * height + IMAGE_ROW_ALIGNMENT];
+        uintptr_t address = (uintptr_t) allocation;
+        pixels = allocation + (IMAGE_ROW_ALIGNMENT - address % IMAGE_ROW_ALIGNMENT) % IMAGE_ROW_ALIGNMENT;
+
+        for (int y = 0; y < height; y++)
+            { // per row
+            Pixel *row = Row(y);
+            for (int x = 0; x < width; x++)
+                row[x] = fill;
+            } // per row
+        } // Image()
+
+    // destructor
+    ~Image()
+        { // ~Image()
+        delete [] allocation;
+        } // ~Image()
+
+    // images are large, so they may be moved but never copied
+    Image(Image &&other)
+        : width(other.width), height(other.height), stride(other.stride),
+        allocation(other.allocation), pixels(other.pixels)
+        { // Image()
+        other.allocation = NULL;
+        other.pixels = NULL;
+        other.width = other.height = 0;
+        } // Image()
+    Image(const Image &other) = delete;
+    Image &operator =(const Image &other) = delete;
+
+    // the start of a row
+    Pixel *Row(int y)
+        { return (Pixel *) (pixels + y * stride); }
+    const Pixel *Row(int y) const
+        { return (const Pixel *) (pixels + y * stride); }
+
+    // access to a single pixel
+    Pixel &operator ()(int x, int y)
+        { return Row(y)[x]; }
+    const Pixel &operator ()(int x, int y) const
+        { return Row(y)[x]; }
+
+    // the number of bytes an image of a given size will allocate
+    static size_t AllocationBytes(int width, int height)
+        { return RowBytes(width) * height + IMAGE_ROW_ALIGNMENT; }
+
+    private:
+    // rows are padded to the alignment
+    static size_t RowBytes(int width)
+        { // RowBytes()
+        size_t bytes = sizeof(Pixel) * width;
+        return (bytes + IMAGE_ROW_ALIGNMENT - 1) / IMAGE_ROW_ALIGNMENT * IMAGE_ROW_ALIGNMENT;
+        } // RowBytes()
+
+    // the raw allocation, and the aligned start of row 0 within it
+    unsigned char *allocation;
+    unsigned char *pixels;
+    }; // class Image
+
+// end of include guard for Image
+#endif
@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ImageWriter.cpp
+//  ------------------------
+//
+//  Writes images to disk as binary (P6) PPM or as PNG.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "ImageWriter.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// zlib provides deflate and the CRC for PNG
+#include <zlib.h>
+
+// size of the staging buffer between the pixels and the file
+#define WRITE_BUFFER_BYTES (4 << 20)
+
+// zlib level for PNG: the maps are mostly flat, so fast compression loses little
+#define PNG_COMPRESSION_LEVEL 3
+
+// packs one row into file order: 8-bit values as they are,
+// 16-bit values big-endian as both PPM and PNG require
+static void PackRow(const RGB8 *row, int width, unsigned char *out)
+    { // PackRow()
+    memcpy(out, row, (size_t) width * 3);
+    } // PackRow()
+
+static void PackRow(const RGB16 *row, int width, unsigned char *out)
+    { // PackRow()
+    for (int x = 0; x < width; x++)
+        { // per pixel
+        const unsigned short values[3] = { row[x].r, row[x].g, row[x].b };
+        for (int component = 0; component < 3; component++)
+            { // per component
+            *out++ = (unsigned char) (values[component] >> 8);
+            *out++ = (unsigned char) (values[component] & 0xFF);
+            } // per component
+        } // per pixel
+    } // PackRow()
+
+// writes a binary PPM for either pixel depth
+template <class Pixel>
+static bool WritePPMTemplate(const Image<Pixel> &image, const std::string &fileName)
+    { // WritePPMTemplate()
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (file == NULL)
+        return false;
+
+    // header: magic number, width & height, maximum value
+    fprintf(file, "P6\n%d %d\n%d\n", image.width, image.height, (int) Pixel::MaxValue());
+
+    // pack as many whole rows as fit into the staging buffer, then write them in one go
+    // the pixel structs have no padding, so a packed row is the same size as an unpacked one
+    size_t rowBytes = sizeof(Pixel) * image.width;
+    size_t rowsPerWrite = std::max((size_t) 1, (size_t) WRITE_BUFFER_BYTES / rowBytes);
+    std::vector<unsigned char> buffer(rowBytes * rowsPerWrite);
+
+    bool succeeded = true;
+    for (int y = 0; (y < image.height) && succeeded; y += (int) rowsPerWrite)
+        { // per batch of rows
+        int rows = std::min((int) rowsPerWrite, image.height - y);
+        for (int row = 0; row < rows; row++)
+            PackRow(image.Row(y + row), image.width, &buffer[row * rowBytes]);
+        succeeded = (fwrite(&buffer[0], rowBytes, rows, file) == (size_t) rows);
+        } // per batch of rows
+
+    if (fclose(file) != 0)
+        succeeded = false;
+    return succeeded;
+    } // WritePPMTemplate()
+
+bool WritePPM(const Image<RGB8> &image, const std::string &fileName)
+    { // WritePPM()
+    return WritePPMTemplate(image, fileName);
+    } // WritePPM()
+
+bool WritePPM(const Image<RGB16> &image, const std::string &fileName)
+    { // WritePPM()
+    return WritePPMTemplate(image, fileName);
+    } // WritePPM()
+
+// writes one PNG chunk: length, type, data, then the CRC of type & data
+static bool WritePNGChunk(FILE *file, const char *type, const unsigned char *data, size_t length)
+    { // WritePNGChunk()
+    unsigned char header[8] = { (unsigned char) (length >> 24), (unsigned char) (length >> 16),
+                                (unsigned char) (length >> 8), (unsigned char) length,
+                                (unsigned char) type[0], (unsigned char) type[1],
+                                (unsigned char) type[2], (unsigned char) type[3] };
+    uLong crc = crc32(0L, header + 4, 4);
+    if (length > 0)
+        crc = crc32(crc, data, (uInt) length);
+    unsigned char trailer[4] = { (unsigned char) (crc >> 24), (unsigned char) (crc >> 16),
+                                 (unsigned char) (crc >> 8), (unsigned char) crc };
+
+    return (fwrite(header, 1, 8, file) == 8)
+        && ((length == 0) || (fwrite(data, 1, length, file) == length))
+        && (fwrite(trailer, 1, 4, file) == 4);
+    } // WritePNGChunk()
+
+// writes a PNG for either pixel depth
+template <class Pixel>
+static bool WritePNGTemplate(const Image<Pixel> &image, const std::string &fileName)
+    { // WritePNGTemplate()
+    const size_t bytesPerPixel = sizeof(Pixel);
+    const int bitDepth = 8 * bytesPerPixel / 3;
+    const size_t rowBytes = bytesPerPixel * image.width;
+
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (file == NULL)
+        return false;
+
+    // signature, then the header chunk: RGB, no interlacing
+    static const unsigned char signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+    unsigned char header[13] = { (unsigned char) (image.width >> 24), (unsigned char) (image.width >> 16),
+                                 (unsigned char) (image.width >> 8), (unsigned char) image.width,
+                                 (unsigned char) (image.height >> 24), (unsigned char) (image.height >> 16),
+                                 (unsigned char) (image.height >> 8), (unsigned char) image.height,
+                                 (unsigned char) bitDepth, 2, 0, 0, 0 };
+    bool succeeded = (fwrite(signature, 1, 8, file) == 8) && WritePNGChunk(file, "IHDR", header, 13);
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit(&stream, PNG_COMPRESSION_LEVEL) != Z_OK)
+        { // no zlib
+        fclose(file);
+        return false;
+        } // no zlib
+
+    // each row is a filter byte followed by the pixels; we use the Sub filter
+    // (each byte minus the one a pixel to its left), which suits smooth maps
+    std::vector<unsigned char> packed(rowBytes);
+    std::vector<unsigned char> filtered(rowBytes + 1);
+    std::vector<unsigned char> compressed(WRITE_BUFFER_BYTES);
+    stream.next_out = &compressed[0];
+    stream.avail_out = (uInt) compressed.size();
+
+    for (int y = 0; (y <= image.height) && succeeded; y++)
+        { // per row, plus one pass to flush
+        int flush = Z_NO_FLUSH;
+        if (y < image.height)
+            { // filter a row
+            PackRow(image.Row(y), image.width, &packed[0]);
+            filtered[0] = 1;
+            for (size_t byte = 0; byte < rowBytes; byte++)
+                filtered[byte + 1] = packed[byte] - ((byte >= bytesPerPixel) ? packed[byte - bytesPerPixel] : 0);
+            stream.next_in = &filtered[0];
+            stream.avail_in = (uInt) filtered.size();
+            } // filter a row
+        else
+            flush = Z_FINISH;
+
+        // deflate, emitting an IDAT chunk every time the output buffer fills
+        int status;
+        do
+            { // until zlib has consumed the row
+            status = deflate(&stream, flush);
+            if ((stream.avail_out == 0) || (status == Z_STREAM_END))
+                { // emit a chunk
+                size_t bytes = compressed.size() - stream.avail_out;
+                succeeded = succeeded && WritePNGChunk(file, "IDAT", &compressed[0], bytes);
+                stream.next_out = &compressed[0];
+                stream.avail_out = (uInt) compressed.size();
+                } // emit a chunk
+            } // until zlib has consumed the row
+        while (succeeded && (((flush == Z_NO_FLUSH) && (stream.avail_in > 0)) || ((flush == Z_FINISH) && (status != Z_STREAM_END))));
+        } // per row
+
+    deflateEnd(&stream);
+    succeeded = succeeded && WritePNGChunk(file, "IEND", NULL, 0);
+    if (fclose(file) != 0)
+        succeeded = false;
+    return succeeded;
+    } // WritePNGTemplate()
+
+bool WritePNG(const Image<RGB8> &image, const std::string &fileName)
+    { // WritePNG()
+    return WritePNGTemplate(image, fileName);
+    } // WritePNG()
+
+bool WritePNG(const Image<RGB16> &image, const std::string &fileName)
+    { // WritePNG()
+    return WritePNGTemplate(image, fileName);
+    } // WritePNG()
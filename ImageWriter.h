@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ImageWriter.h
+//  ------------------------
+//
+//  Writes images to disk as binary (P6) PPM or as PNG.
+//
+//  Pixels are packed into a large staging buffer and
+//  handed to the file a few megabytes at a time, rather
+//  than being formatted one value at a time.
+//
+///////////////////////////////////////////////////
+
+// include guard for ImageWriter
+#ifndef _IMAGE_WRITER_H
+#define _IMAGE_WRITER_H
+
+#include <string>
+
+#include "Image.h"
+
+// binary PPM, with a maximum value of 255 or 65535 respectively
+// returns true on success, false otherwise
+bool WritePPM(const Image<RGB8> &image, const std::string &fileName);
+bool WritePPM(const Image<RGB16> &image, const std::string &fileName);
+
+// PNG, RGB with 8 or 16 bits per channel
+// returns true on success, false otherwise
+bool WritePNG(const Image<RGB8> &image, const std::string &fileName);
+bool WritePNG(const Image<RGB16> &image, const std::string &fileName);
+
+// end of include guard for ImageWriter
+#endif
@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MappedFile.cpp
+//  ------------------------
+//
+//  A read-only memory mapping of a whole file.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "MappedFile.h"
+
+// POSIX file & memory mapping calls
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// constructor maps nothing
+MappedFile::MappedFile()
+    : data(NULL), size(0)
+    { // MappedFile()
+    } // MappedFile()
+
+// unmaps the file
+MappedFile::~MappedFile()
+    { // ~MappedFile()
+    Close();
+    } // ~MappedFile()
+
+// maps the named file, returns false if it cannot be opened or mapped
+bool MappedFile::Open(const std::string &fileName)
+    { // Open()
+    Close();
+
+    int descriptor = open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+
+    struct stat status;
+    if ((fstat(descriptor, &status) != 0) || !S_ISREG(status.st_mode))
+        { // not a plain file
+        close(descriptor);
+        return false;
+        } // not a plain file
+
+    // an empty file cannot be mapped, but is still a file
+    size = (size_t) status.st_size;
+    if (size > 0)
+        { // map it
+        void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED)
+            { // map failed
+            close(descriptor);
+            size = 0;
+            return false;
+            } // map failed
+        data = (const char *) mapping;
+
+        // we read the file front to back
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        } // map it
+
+    // the mapping stays valid once the descriptor is closed
+    close(descriptor);
+    return true;
+    } // Open()
+
+// unmaps the file, if any
+void MappedFile::Close()
+    { // Close()
+    if (data != NULL)
+        munmap((void *) data, size);
+    data = NULL;
+    size = 0;
+    } // Close()
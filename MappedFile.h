@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MappedFile.h
+//  ------------------------
+//
+//  A read-only memory mapping of a whole file, so that
+//  it can be scanned in place without copying it into
+//  a stream buffer first.
+//
+///////////////////////////////////////////////////
+
+// include guard for MappedFile
+#ifndef _MAPPED_FILE_H
+#define _MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile
+    { // class MappedFile
+    public:
+    // the contents of the file, and their size in bytes
+    // data is NULL for an empty (or unopened) file
+    const char *data;
+    size_t size;
+
+    // constructor maps nothing
+    MappedFile();
+
+    // unmaps the file
+    ~MappedFile();
+
+    // maps the named file, returns false if it cannot be opened or mapped
+    bool Open(const std::string &fileName);
+
+    // unmaps the file, if any
+    void Close();
+
+    private:
+    // a mapping cannot be shared
+    MappedFile(const MappedFile &);
+    MappedFile &operator = (const MappedFile &);
+    }; // class MappedFile
+
+// end of include guard for MappedFile
+#endif
@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshBuffers.cpp
+//  ------------------------
+//
+//  Keeps a welded mesh in GPU buffers.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "MeshBuffers.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+
+// constructor creates no buffers, as there is no context yet
+MeshBuffers::MeshBuffers()
+    : mesh(NULL),
+    vertexBuffer(QOpenGLBuffer::VertexBuffer),
+    indexBuffer(QOpenGLBuffer::IndexBuffer),
+    uploadedVertices(0),
+    uploadedIndices(0),
+    meshlets(NULL)
+    { // MeshBuffers()
+    } // MeshBuffers()
+
+// creates the buffers for a mesh, uploading the first slice
+void MeshBuffers::Create(const WeldedMesh &newMesh)
+    { // Create()
+    initializeOpenGLFunctions();
+    mesh = &newMesh;
+
+    // allocate both buffers at full size; the data follow a slice at a time
+    vertexBuffer.create();
+    vertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    vertexBuffer.bind();
+    vertexBuffer.allocate((int) (mesh->vertices.size() * sizeof(WeldedVertex)));
+    indexBuffer.create();
+    indexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    indexBuffer.bind();
+    indexBuffer.allocate((int) (mesh->indices.size() * sizeof(unsigned int)));
+
+    // with an array object (GL 3.0, or the extension) the layout is recorded
+    // once; without one it is set again every frame
+    if (vertexArray.create())
+        { // array object
+        QOpenGLVertexArrayObject::Binder binder(&vertexArray);
+        vertexBuffer.bind();
+        indexBuffer.bind();
+        SetArrays();
+        } // array object
+    vertexBuffer.release();
+    indexBuffer.release();
+
+    uploadedVertices = uploadedIndices = 0;
+    Upload();
+    } // Create()
+
+// uploads the next slice, if there is one
+// returns true once the whole mesh is on the GPU
+bool MeshBuffers::Upload()
+    { // Upload()
+    if (mesh == NULL)
+        return false;
+    if (IsUploaded())
+        return true;
+
+    // take whole triangles until the slice is full: their indices,
+    // and whichever vertices they are the first to use
+    size_t endIndex = uploadedIndices, endVertex = uploadedVertices;
+    size_t bytes = 0;
+    while ((endIndex < mesh->indices.size()) && (bytes < MESH_UPLOAD_SLICE_BYTES))
+        { // per triangle
+        for (int vertex = 0; vertex < 3; vertex++)
+            endVertex = std::max(endVertex, (size_t) mesh->indices[endIndex + vertex] + 1);
+        endIndex += 3;
+        bytes = (endIndex - uploadedIndices) * sizeof(unsigned int) + (endVertex - uploadedVertices) * sizeof(WeldedVertex);
+        } // per triangle
+
+    vertexBuffer.bind();
+    vertexBuffer.write((int) (uploadedVertices * sizeof(WeldedVertex)), &mesh->vertices[uploadedVertices],
+                       (int) ((endVertex - uploadedVertices) * sizeof(WeldedVertex)));
+    vertexBuffer.release();
+    indexBuffer.bind();
+    indexBuffer.write((int) (uploadedIndices * sizeof(unsigned int)), &mesh->indices[uploadedIndices],
+                      (int) ((endIndex - uploadedIndices) * sizeof(unsigned int)));
+    indexBuffer.release();
+
+    uploadedVertices = endVertex;
+    uploadedIndices = endIndex;
+    return uploadedIndices == mesh->indices.size();
+    } // Upload()
+
+// whether the whole mesh is on the GPU
+bool MeshBuffers::IsUploaded() const
+    { // IsUploaded()
+    return (mesh != NULL) && (uploadedIndices == mesh->indices.size());
+    } // IsUploaded()
+
+// points the fixed-function arrays at the bound buffers
+void MeshBuffers::SetArrays()
+    { // SetArrays()
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(WeldedVertex), (const GLvoid *) offsetof(WeldedVertex, position));
+    glEnableClientState(GL_COLOR_ARRAY);
+    glColorPointer(3, GL_FLOAT, sizeof(WeldedVertex), (const GLvoid *) offsetof(WeldedVertex, colour));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(WeldedVertex), (const GLvoid *) offsetof(WeldedVertex, texCoord));
+    } // SetArrays()
+
+// draws the runs (or everything) from the bound buffers
+void MeshBuffers::DrawRuns()
+    { // DrawRuns()
+    if (meshlets == NULL)
+        glDrawElements(GL_TRIANGLES, (GLsizei) uploadedIndices, GL_UNSIGNED_INT, 0);
+    else
+        for (size_t run = 0; run < runFirsts.size(); run++)
+            glDrawElements(GL_TRIANGLES, (GLsizei) runCounts[run], GL_UNSIGNED_INT,
+                           (const GLvoid *) (runFirsts[run] * sizeof(unsigned int)));
+    } // DrawRuns()
+
+// draws as much of the mesh as has been uploaded & can be seen
+size_t MeshBuffers::Render(const AttributedObject &object, const RenderParameters *renderParameters)
+    { // Render()
+    if (uploadedIndices == 0)
+        return 0;
+
+    // make sure that textures are disabled
+    glDisable(GL_TEXTURE_2D);
+
+    // the scale & centring that Render applies to each vertex go in the matrix instead
+    float scale = renderParameters->zoomScale / object.objectSize;
+    glPushMatrix();
+    glScalef(scale, scale, scale);
+    glTranslatef(-object.centreOfGravity.x, -object.centreOfGravity.y, -object.centreOfGravity.z);
+
+    // the clusters are tested in object space, against the matrices as they now stand
+    size_t drawnIndices = uploadedIndices;
+    if (meshlets != NULL)
+        { // culling
+        float modelView[16], projection[16];
+        glGetFloatv(GL_MODELVIEW_MATRIX, modelView);
+        glGetFloatv(GL_PROJECTION_MATRIX, projection);
+        float centre[3] = { object.centreOfGravity.x, object.centreOfGravity.y, object.centreOfGravity.z };
+        VisibleMeshletRuns(*meshlets, centre, object.objectSize, modelView, projection, (unsigned int) uploadedIndices,
+                           runFirsts, runCounts);
+        drawnIndices = 0;
+        for (size_t run = 0; run < runCounts.size(); run++)
+            drawnIndices += runCounts[run];
+        } // culling
+
+    if (vertexArray.isCreated())
+        { // array object
+        QOpenGLVertexArrayObject::Binder binder(&vertexArray);
+        DrawRuns();
+        } // array object
+    else
+        { // no array object
+        vertexBuffer.bind();
+        indexBuffer.bind();
+        SetArrays();
+        DrawRuns();
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        vertexBuffer.release();
+        indexBuffer.release();
+        } // no array object
+
+    glPopMatrix();
+    return drawnIndices / 3;
+    } // Render()
+
+// frees the buffers; the widget's context must be current
+void MeshBuffers::Destroy()
+    { // Destroy()
+    vertexArray.destroy();
+    vertexBuffer.destroy();
+    indexBuffer.destroy();
+    mesh = NULL;
+    meshlets = NULL;
+    uploadedVertices = uploadedIndices = 0;
+    } // Destroy()
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshBuffers.h
+//  ------------------------
+//
+//  Keeps a welded mesh (one level of detail of an
+//  object) in GPU buffers, so that each frame is one
+//  glDrawElements call instead of a glColor3f &
+//  glVertex3f call per corner.
+//
+//  The centring & scaling are applied through the
+//  model-view matrix, so the vertices are uploaded
+//  once and never touched again.
+//
+//  Large meshes are uploaded a slice per frame, so
+//  the window appears at once and fills in as the
+//  upload proceeds.  Welding numbers vertices in the
+//  order the faces first use them, so the faces
+//  uploaded so far only ever use the vertices
+//  uploaded so far, and can be drawn straight away.
+//
+//  Once a mesh's meshlets are given, only the runs
+//  of clusters that can be seen are drawn, as one
+//  glDrawElements call per run.
+//
+//  Only fixed-function vertex, colour & texture
+//  coordinate arrays are used, so this runs on Mesa's
+//  llvmpipe as well as on a GPU.
+//
+///////////////////////////////////////////////////
+
+// include guard for MeshBuffers
+#ifndef _MESH_BUFFERS_H
+#define _MESH_BUFFERS_H
+
+#include <cstddef>
+#include <vector>
+
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QOpenGLVertexArrayObject>
+
+#include "AttributedObject.h"
+#include "Meshlets.h"
+#include "RenderParameters.h"
+#include "WeldedMesh.h"
+
+// at most this much is uploaded in one frame
+#define MESH_UPLOAD_SLICE_BYTES (8 << 20)
+
+class MeshBuffers : protected QOpenGLFunctions
+    { // class MeshBuffers
+    public:
+    // constructor creates no buffers, as there is no context yet
+    MeshBuffers();
+
+    // creates the buffers for a mesh, uploading the first slice
+    // the mesh is not copied, so it must outlive the buffers
+    // the widget's context must be current
+    void Create(const WeldedMesh &newMesh);
+
+    // uploads the next slice, if there is one
+    // returns true once the whole mesh is on the GPU
+    bool Upload();
+
+    // whether the whole mesh is on the GPU (false if there is no mesh)
+    bool IsUploaded() const;
+
+    // how many triangles are on the GPU
+    size_t UploadedTriangles() const
+        { return uploadedIndices / 3; }
+
+    // culls by the mesh's meshlets from now on, or by none if NULL
+    // the meshlets are not copied, so they must outlive the buffers
+    void SetMeshlets(const std::vector<Meshlet> *newMeshlets)
+        { meshlets = newMeshlets; }
+
+    // draws as much of the mesh as has been uploaded & can be seen
+    // returns the number of triangles drawn
+    size_t Render(const AttributedObject &object, const RenderParameters *renderParameters);
+
+    // frees the buffers; the widget's context must be current
+    void Destroy();
+
+    private:
+    // the mesh as it is laid out in the buffers
+    const WeldedMesh *mesh;
+
+    // vertices & indices, and the array object that records their layout
+    QOpenGLBuffer vertexBuffer, indexBuffer;
+    QOpenGLVertexArrayObject vertexArray;
+
+    // how much of the mesh is on the GPU
+    size_t uploadedVertices, uploadedIndices;
+
+    // the mesh's clusters, if culling
+    const std::vector<Meshlet> *meshlets;
+
+    // the runs of indices drawn this frame
+    std::vector<unsigned int> runFirsts, runCounts;
+
+    // draws the runs (or everything) from the bound buffers
+    void DrawRuns();
+
+    // points the fixed-function arrays at the bound buffers
+    void SetArrays();
+    }; // class MeshBuffers
+
+// end of include guard for MeshBuffers
+#endif
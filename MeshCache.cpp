@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshCache.cpp
+//  ------------------------
+//
+//  A binary sidecar holding the arrays of an
+//  AttributedObject.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "MeshCache.h"
+
+// include the C++ standard libraries we want
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// POSIX, for the source's size & time and the process ID
+#include <sys/stat.h>
+#include <unistd.h>
+
+// local includes
+#include "MappedFile.h"
+
+// the arrays are aligned to this many bytes within the file
+#define MESH_CACHE_ALIGNMENT 64
+
+// the number of arrays in the file
+#define MESH_CACHE_ARRAYS 8
+
+// the arrays are copied as they stand, so the vector type must be three packed floats
+static_assert(sizeof(Cartesian3) == 3 * sizeof(float), "Cartesian3 must be three packed floats");
+
+// identifies the file type, and is written in the byte order of the machine
+static const char meshCacheMagic[8] = { 'A', 'M', 'E', 'S', 'H', '\r', '\n', 0x1A };
+static const uint32_t meshCacheByteOrder = 0x01020304;
+
+// the fixed part of the file
+struct MeshCacheHeader
+    { // struct MeshCacheHeader
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+
+    // the key: what the source looked like when the cache was made
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    uint64_t sourceHash;
+
+    // the number of elements in each array and where it starts in the file
+    // in the order vertices, colours, normals, texture coordinates,
+    // then the face vertex, colour, normal & texture coordinate IDs
+    uint64_t counts[MESH_CACHE_ARRAYS];
+    uint64_t offsets[MESH_CACHE_ARRAYS];
+
+    // computed after reading
+    float centreOfGravity[3];
+    float objectSize;
+    }; // struct MeshCacheHeader
+
+// the size & modification time (in nanoseconds) of a file
+static bool SourceStatus(const std::string &sourcePath, uint64_t &size, int64_t &modified)
+    { // SourceStatus()
+    struct stat status;
+    if (stat(sourcePath.c_str(), &status) != 0)
+        return false;
+    size = (uint64_t) status.st_size;
+    modified = (int64_t) status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+    return true;
+    } // SourceStatus()
+
+// a 64-bit hash of a block of memory, a word at a time
+static uint64_t HashBytes(const char *data, size_t size)
+    { // HashBytes()
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash = size * multiplier;
+    size_t word = 0;
+    for ( ; word + 8 <= size; word += 8)
+        { // per word
+        uint64_t value;
+        memcpy(&value, data + word, 8);
+        hash = (hash ^ value) * multiplier;
+        hash ^= hash >> 32;
+        } // per word
+    uint64_t tail = 0;
+    memcpy(&tail, data + word, size - word);
+    hash = (hash ^ tail) * multiplier;
+    return hash ^ (hash >> 29);
+    } // HashBytes()
+
+// the size of one element of each array in the file
+static size_t ElementSize(int array)
+    { // ElementSize()
+    return (array < 4) ? sizeof(Cartesian3) : sizeof(unsigned int);
+    } // ElementSize()
+
+// rounds a file offset up to the alignment
+static uint64_t Align(uint64_t offset)
+    { // Align()
+    return (offset + MESH_CACHE_ALIGNMENT - 1) & ~(uint64_t) (MESH_CACHE_ALIGNMENT - 1);
+    } // Align()
+
+// loads the object from the cache of the source file if it is valid
+// returns false if there is no cache, or it is stale, unreadable or damaged
+bool ReadMeshCache(const std::string &sourcePath, AttributedObject &object)
+    { // ReadMeshCache()
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    if (!SourceStatus(sourcePath, sourceSize, sourceModified))
+        return false;
+
+    MappedFile cache;
+    if (!cache.Open(sourcePath + MESH_CACHE_EXTENSION) || (cache.size < sizeof(MeshCacheHeader)))
+        return false;
+
+    // check that the header is one we wrote, on a machine like this one
+    MeshCacheHeader header;
+    memcpy(&header, cache.data, sizeof(header));
+    if ((memcmp(header.magic, meshCacheMagic, sizeof(meshCacheMagic)) != 0) || (header.version != MESH_CACHE_VERSION)
+        || (header.byteOrder != meshCacheByteOrder))
+        return false;
+
+    // check the key, only hashing the source if its time has changed
+    if (header.sourceSize != sourceSize)
+        return false;
+    if (header.sourceModified != sourceModified)
+        { // touched
+        MappedFile source;
+        if (!source.Open(sourcePath) || (HashBytes(source.data, source.size) != header.sourceHash))
+            return false;
+        } // touched
+
+    // check that every array lies inside the file before touching any of them
+    for (int array = 0; array < MESH_CACHE_ARRAYS; array++)
+        if ((header.offsets[array] > cache.size) || (header.counts[array] > (cache.size - header.offsets[array]) / ElementSize(array)))
+            return false;
+
+    // and copy them out of the mapping, one block each
+    std::vector<Cartesian3> *vectors[4] = { &object.vertices, &object.colours, &object.normals, &object.textureCoords };
+    std::vector<unsigned int> *ids[4] = { &object.faceVertices, &object.faceColours, &object.faceNormals, &object.faceTexCoords };
+    for (int array = 0; array < 4; array++)
+        { // per array pair
+        const Cartesian3 *vectorData = (const Cartesian3 *) (cache.data + header.offsets[array]);
+        vectors[array]->assign(vectorData, vectorData + header.counts[array]);
+        const unsigned int *idData = (const unsigned int *) (cache.data + header.offsets[array + 4]);
+        ids[array]->assign(idData, idData + header.counts[array + 4]);
+        } // per array pair
+
+    // the hash is skipped while the source is untouched, so a damaged or edited
+    // cache is only caught here: every corner needs all four IDs, each in range
+    size_t corners = object.faceVertices.size();
+    bool valid = (corners % 3 == 0) && (object.faceColours.size() == corners)
+              && (object.faceNormals.size() == corners) && (object.faceTexCoords.size() == corners);
+    for (size_t corner = 0; valid && (corner < corners); corner++)
+        valid = (object.faceVertices[corner] < object.vertices.size()) && (object.faceColours[corner] < object.colours.size())
+             && (object.faceNormals[corner] < object.normals.size()) && (object.faceTexCoords[corner] < object.textureCoords.size());
+    if (!valid)
+        { // bad cache
+        std::cout << "Ignoring damaged mesh cache " << sourcePath << MESH_CACHE_EXTENSION << std::endl;
+        for (int array = 0; array < 4; array++)
+            { // per array pair
+            vectors[array]->clear();
+            ids[array]->clear();
+            } // per array pair
+        return false;
+        } // bad cache
+
+    object.centreOfGravity = Cartesian3(header.centreOfGravity[0], header.centreOfGravity[1], header.centreOfGravity[2]);
+    object.objectSize = header.objectSize;
+    return true;
+    } // ReadMeshCache()
+
+// writes the cache for an object just parsed from the given text of the source file
+// returns false if the cache could not be written
+bool WriteMeshCache(const std::string &sourcePath, const char *text, size_t size, const AttributedObject &object)
+    { // WriteMeshCache()
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+    header.version = MESH_CACHE_VERSION;
+    header.byteOrder = meshCacheByteOrder;
+    if (!SourceStatus(sourcePath, header.sourceSize, header.sourceModified) || (header.sourceSize != size))
+        return false;
+    header.sourceHash = HashBytes(text, size);
+
+    // the arrays, in file order
+    const void *arrays[MESH_CACHE_ARRAYS] =
+        {
+        object.vertices.data(), object.colours.data(), object.normals.data(), object.textureCoords.data(),
+        object.faceVertices.data(), object.faceColours.data(), object.faceNormals.data(), object.faceTexCoords.data()
+        };
+    size_t counts[MESH_CACHE_ARRAYS] =
+        {
+        object.vertices.size(), object.colours.size(), object.normals.size(), object.textureCoords.size(),
+        object.faceVertices.size(), object.faceColours.size(), object.faceNormals.size(), object.faceTexCoords.size()
+        };
+
+    uint64_t offset = Align(sizeof(header));
+    for (int array = 0; array < MESH_CACHE_ARRAYS; array++)
+        { // per array
+        header.counts[array] = counts[array];
+        header.offsets[array] = offset;
+        offset = Align(offset + counts[array] * ElementSize(array));
+        } // per array
+    header.centreOfGravity[0] = object.centreOfGravity.x;
+    header.centreOfGravity[1] = object.centreOfGravity.y;
+    header.centreOfGravity[2] = object.centreOfGravity.z;
+    header.objectSize = object.objectSize;
+
+    // write to a private name, then rename, so that a reader (or another
+    // process writing the same cache) never sees a partial file
+    std::string cachePath = sourcePath + MESH_CACHE_EXTENSION;
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%ld.tmp", (long) getpid());
+    std::string temporaryPath = cachePath + suffix;
+    FILE *file = fopen(temporaryPath.c_str(), "wb");
+    if (file == NULL)
+        return false;
+
+    static const char padding[MESH_CACHE_ALIGNMENT] = { 0 };
+    bool succeeded = (fwrite(&header, sizeof(header), 1, file) == 1);
+    uint64_t written = sizeof(header);
+    for (int array = 0; (array < MESH_CACHE_ARRAYS) && succeeded; array++)
+        { // per array
+        succeeded = (fwrite(padding, 1, header.offsets[array] - written, file) == header.offsets[array] - written);
+        size_t bytes = counts[array] * ElementSize(array);
+        succeeded = succeeded && ((bytes == 0) || (fwrite(arrays[array], 1, bytes, file) == bytes));
+        written = header.offsets[array] + bytes;
+        } // per array
+
+    if (fclose(file) != 0)
+        succeeded = false;
+    if (succeeded)
+        succeeded = (rename(temporaryPath.c_str(), cachePath.c_str()) == 0);
+    if (!succeeded)
+        remove(temporaryPath.c_str());
+    return succeeded;
+    } // WriteMeshCache()
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshCache.h
+//  ------------------------
+//
+//  A binary sidecar (<model>.amesh) holding the arrays
+//  of an AttributedObject exactly as they are in memory,
+//  so that a model only has to be parsed once.
+//
+//  The cache is keyed by the size, modification time
+//  and a hash of the text it was made from.  If the
+//  size & time still match it is used straight away;
+//  if only the time differs (the file was touched or
+//  copied), the text is hashed to decide.
+//
+//  The file is a fixed header followed by the arrays,
+//  each 64-byte aligned.  It is mapped when it is
+//  loaded, and each array is copied out of the mapping
+//  in one block.
+//
+///////////////////////////////////////////////////
+
+// include guard for MeshCache
+#ifndef _MESH_CACHE_H
+#define _MESH_CACHE_H
+
+#include <cstddef>
+#include <string>
+
+#include "AttributedObject.h"
+
+// the extension added to a model's path to name its cache
+#define MESH_CACHE_EXTENSION ".amesh"
+
+// bumped whenever the layout of the file changes
+#define MESH_CACHE_VERSION 1
+
+// loads the object from the cache of the source file if it is valid
+// returns false if there is no cache, or it is stale, unreadable or damaged
+bool ReadMeshCache(const std::string &sourcePath, AttributedObject &object);
+
+// writes the cache for an object just parsed from the given text of the source file
+// returns false if the cache could not be written
+bool WriteMeshCache(const std::string &sourcePath, const char *text, size_t size, const AttributedObject &object);
+
+// end of include guard for MeshCache
+#endif
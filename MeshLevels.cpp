@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshLevels.cpp
+//  ------------------------
+//
+//  A chain of levels of detail for the viewer.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "MeshLevels.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+
+#include "MeshSimplifier.h"
+
+// constructor builds no levels
+MeshLevels::MeshLevels()
+    : readyLevels(0),
+    readyMeshlets(0)
+    { // MeshLevels()
+    } // MeshLevels()
+
+// destructor waits for the simplifying thread
+MeshLevels::~MeshLevels()
+    { // ~MeshLevels()
+    Wait();
+    } // ~MeshLevels()
+
+// welds the object into level 0, then starts simplifying the others
+void MeshLevels::Build(const AttributedObject &object)
+    { // Build()
+    levels[0].Weld(object);
+    std::cout << "Welded " << levels[0].indices.size() << " corners into " << levels[0].vertices.size()
+              << " vertices (" << levels[0].DedupRatio() << ":1), " << WeldedMesh::ObjectBytes(object)
+              << " bytes down to " << levels[0].Bytes() << std::endl;
+    readyLevels.store(1, std::memory_order_release);
+
+    builder = std::thread(&MeshLevels::BuildCoarserLevels, this);
+    } // Build()
+
+// waits until every level has been simplified
+void MeshLevels::Wait()
+    { // Wait()
+    if (builder.joinable())
+        builder.join();
+    } // Wait()
+
+// body of the simplifying thread, which also builds the meshlets
+void MeshLevels::BuildCoarserLevels()
+    { // BuildCoarserLevels()
+    BuildMeshlets(levels[0], meshlets[0]);
+    readyMeshlets.store(1, std::memory_order_release);
+
+    for (int level = 1; level < LOD_MAXIMUM_LEVELS; level++)
+        { // per level
+        size_t previousTriangles = levels[level - 1].indices.size() / 3;
+        size_t targetTriangles = previousTriangles / LOD_REDUCTION;
+        if (targetTriangles < LOD_MINIMUM_TRIANGLES)
+            break;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        SimplifyMesh(levels[level - 1], targetTriangles, levels[level]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // a level that barely shrank (everything left is locked) is not worth keeping
+        size_t triangles = levels[level].indices.size() / 3;
+        if (4 * triangles > 3 * previousTriangles)
+            { // not worth it
+            levels[level] = WeldedMesh();
+            break;
+            } // not worth it
+
+        std::cout << "Level of detail " << level << ": " << triangles << " triangles, "
+                  << levels[level].vertices.size() << " vertices in " << seconds << " s" << std::endl;
+        BuildMeshlets(levels[level], meshlets[level]);
+        readyMeshlets.store(level + 1, std::memory_order_release);
+        readyLevels.store(level + 1, std::memory_order_release);
+        } // per level
+    } // BuildCoarserLevels()
+
+// the coarsest of levels 0 .. usableLevels-1 that still has enough triangles
+// for an object filling a window of the given size at the given zoom
+int MeshLevels::ChooseLevel(int usableLevels, int width, int height, float zoomScale, bool dragging) const
+    { // ChooseLevel()
+    // the unit sphere spans the shorter side of the window at zoom 1, and the
+    // front half of the surface (about half the triangles) covers its disc
+    float radius = 0.5f * zoomScale * std::min(width, height);
+    float pixelsPerTriangle = dragging ? LOD_DRAG_PIXELS_PER_TRIANGLE : LOD_PIXELS_PER_TRIANGLE;
+    double wantedTriangles = 2.0 * M_PI * radius * radius / pixelsPerTriangle;
+
+    int chosen = 0;
+    for (int level = 1; level < usableLevels; level++)
+        if (levels[level].indices.size() / 3 >= wantedTriangles)
+            chosen = level;
+    return chosen;
+    } // ChooseLevel()
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshLevels.h
+//  ------------------------
+//
+//  A chain of levels of detail for the viewer: level
+//  0 is the welded object, and each later level has
+//  about a quarter of the triangles of the one before.
+//
+//  Level 0 is ready as soon as Build returns; the
+//  coarser levels are simplified on a thread of their
+//  own and become available one by one, so loading a
+//  large object takes no longer than it did.
+//
+//  Each level is also split into meshlets, on the
+//  same thread, so the viewer can skip clusters of
+//  triangles that face away; level 0's are split
+//  first, and each coarser level's before the level
+//  is made available.
+//
+//  Choosing a level estimates how many triangles the
+//  object can show at its current size on screen, and
+//  asks for fewer while it is being dragged.
+//
+///////////////////////////////////////////////////
+
+// include guard for MeshLevels
+#ifndef _MESH_LEVELS_H
+#define _MESH_LEVELS_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+#include "AttributedObject.h"
+#include "Meshlets.h"
+#include "WeldedMesh.h"
+
+// the most levels kept, counting the full object
+#define LOD_MAXIMUM_LEVELS 5
+
+// each level aims for this fraction of the triangles of the one before
+#define LOD_REDUCTION 4
+
+// no level is simplified below this many triangles
+#define LOD_MINIMUM_TRIANGLES 1000
+
+// screen area (in pixels) each visible triangle should cover,
+// at rest and while the object is being dragged
+#define LOD_PIXELS_PER_TRIANGLE 2.0f
+#define LOD_DRAG_PIXELS_PER_TRIANGLE 32.0f
+
+class MeshLevels
+    { // class MeshLevels
+    public:
+    // constructor builds no levels
+    MeshLevels();
+
+    // destructor waits for the simplifying thread
+    ~MeshLevels();
+
+    // welds the object into level 0, then starts simplifying the others
+    void Build(const AttributedObject &object);
+
+    // waits until every level has been simplified
+    void Wait();
+
+    // how many levels can be used so far (levels 0 .. n-1)
+    int ReadyLevels() const
+        { return readyLevels.load(std::memory_order_acquire); }
+
+    // a ready level
+    const WeldedMesh &Level(int level) const
+        { return levels[level]; }
+
+    // how many levels have meshlets so far (levels 0 .. n-1)
+    int ReadyMeshlets() const
+        { return readyMeshlets.load(std::memory_order_acquire); }
+
+    // the meshlets of a level that has them
+    const std::vector<Meshlet> &Meshlets(int level) const
+        { return meshlets[level]; }
+
+    // the coarsest of levels 0 .. usableLevels-1 that still has enough triangles
+    // for an object filling a window of the given size at the given zoom
+    // usableLevels is the number of levels the caller can draw (at most
+    // ReadyLevels() as it was read), since the simplifying thread may have
+    // finished another level since then
+    int ChooseLevel(int usableLevels, int width, int height, float zoomScale, bool dragging) const;
+
+    private:
+    // the levels, finest first
+    WeldedMesh levels[LOD_MAXIMUM_LEVELS];
+
+    // the meshlets of each level
+    std::vector<Meshlet> meshlets[LOD_MAXIMUM_LEVELS];
+
+    // levels below this are complete and are never touched again
+    std::atomic<int> readyLevels;
+
+    // meshlets of levels below this are complete and are never touched again
+    std::atomic<int> readyMeshlets;
+
+    // simplifies the coarser levels
+    std::thread builder;
+
+    // body of the simplifying thread, which also builds the meshlets
+    void BuildCoarserLevels();
+    }; // class MeshLevels
+
+// end of include guard for MeshLevels
+#endif
@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshOrder.cpp
+//  ------------------------
+//
+//  Reorders the faces & attributes of an object along
+//  a Morton curve through the face centroids.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "MeshOrder.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+// marks an attribute no face has used yet
+#define ORDER_UNUSED 0xFFFFFFFFu
+
+// a face and its place on the curve
+struct FaceKey
+    { // struct FaceKey
+    uint64_t key;
+    unsigned int face;
+
+    // ties keep the file order, so the sort is repeatable
+    bool operator < (const FaceKey &other) const
+        { return (key < other.key) || ((key == other.key) && (face < other.face)); }
+    }; // struct FaceKey
+
+// spreads the low 16 bits of x out to the even bits
+static inline uint64_t Spread2(uint64_t x)
+    { // Spread2()
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0Full;
+    x = (x | (x << 2)) & 0x33333333ull;
+    x = (x | (x << 1)) & 0x55555555ull;
+    return x;
+    } // Spread2()
+
+// spreads the low 21 bits of x out to every third bit
+static inline uint64_t Spread3(uint64_t x)
+    { // Spread3()
+    x &= 0x1FFFFF;
+    x = (x | (x << 32)) & 0x001F00000000FFFFull;
+    x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+    x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+    x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+    x = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+    } // Spread3()
+
+// scales a coordinate within [minimum, minimum + extent] to [0, steps - 1]
+// (NaNs and infinities land at one end or the other)
+static inline uint64_t Quantize(float value, float minimum, float extent, float steps)
+    { // Quantize()
+    float scaled = (extent > 0.0f) ? (value - minimum) / extent * steps : 0.0f;
+    if (!(scaled > 0.0f))
+        return 0;
+    if (scaled >= steps - 1.0f)
+        return (uint64_t) steps - 1;
+    return (uint64_t) scaled;
+    } // Quantize()
+
+// the Morton key of every face's centroid, in UV or object space
+static void FaceKeys(const AttributedObject &object, MeshOrder order, std::vector<FaceKey> &keys)
+    { // FaceKeys()
+    const bool uv = (order == MESH_ORDER_UV);
+    const std::vector<Cartesian3> &points = uv ? object.textureCoords : object.vertices;
+    const std::vector<unsigned int> &ids = uv ? object.faceTexCoords : object.faceVertices;
+    size_t nFaces = ids.size() / 3;
+
+    // the centroids, and the box around them
+    std::vector<Cartesian3> centroids(nFaces);
+    Cartesian3 lowest(0.0, 0.0, 0.0), highest(0.0, 0.0, 0.0);
+    for (size_t face = 0; face < nFaces; face++)
+        { // per face
+        centroids[face] = (points[ids[face*3]] + points[ids[face*3+1]] + points[ids[face*3+2]]) / 3.0;
+        if (face == 0)
+            lowest = highest = centroids[face];
+        lowest = Cartesian3(std::min(lowest.x, centroids[face].x), std::min(lowest.y, centroids[face].y), std::min(lowest.z, centroids[face].z));
+        highest = Cartesian3(std::max(highest.x, centroids[face].x), std::max(highest.y, centroids[face].y), std::max(highest.z, centroids[face].z));
+        } // per face
+    Cartesian3 extent = highest - lowest;
+
+    // 16 bits a side in UV, 21 in object space
+    keys.resize(nFaces);
+    for (size_t face = 0; face < nFaces; face++)
+        { // per face
+        const Cartesian3 &centroid = centroids[face];
+        if (uv)
+            keys[face].key = Spread2(Quantize(centroid.x, lowest.x, extent.x, 65536.0f))
+                | (Spread2(Quantize(centroid.y, lowest.y, extent.y, 65536.0f)) << 1);
+        else
+            keys[face].key = Spread3(Quantize(centroid.x, lowest.x, extent.x, 2097152.0f))
+                | (Spread3(Quantize(centroid.y, lowest.y, extent.y, 2097152.0f)) << 1)
+                | (Spread3(Quantize(centroid.z, lowest.z, extent.z, 2097152.0f)) << 2);
+        keys[face].face = (unsigned int) face;
+        } // per face
+    } // FaceKeys()
+
+// numbers count attributes in the order the ids first use them
+// (attributes never used follow, in their old order)
+static void FirstUseOrder(const std::vector<unsigned int> &ids, size_t count, std::vector<unsigned int> &newId)
+    { // FirstUseOrder()
+    newId.assign(count, ORDER_UNUSED);
+    unsigned int next = 0;
+    for (size_t corner = 0; corner < ids.size(); corner++)
+        if (newId[ids[corner]] == ORDER_UNUSED)
+            newId[ids[corner]] = next++;
+    for (size_t id = 0; id < count; id++)
+        if (newId[id] == ORDER_UNUSED)
+            newId[id] = next++;
+    } // FirstUseOrder()
+
+// renumbers a set of attributes and the ids that refer to them
+static void Renumber(const std::vector<unsigned int> &newId, std::vector<Cartesian3> &values, std::vector<unsigned int> &ids)
+    { // Renumber()
+    std::vector<Cartesian3> renumbered(values.size());
+    for (size_t id = 0; id < values.size(); id++)
+        renumbered[newId[id]] = values[id];
+    values.swap(renumbered);
+    for (size_t corner = 0; corner < ids.size(); corner++)
+        ids[corner] = newId[ids[corner]];
+    } // Renumber()
+
+// moves the corners of a stream of ids into the new face order
+static void PermuteFaces(const std::vector<FaceKey> &keys, std::vector<unsigned int> &ids)
+    { // PermuteFaces()
+    std::vector<unsigned int> permuted(ids.size());
+    for (size_t face = 0; face < keys.size(); face++)
+        for (int vertex = 0; vertex < 3; vertex++)
+            permuted[face*3+vertex] = ids[keys[face].face*3+vertex];
+    ids.swap(permuted);
+    } // PermuteFaces()
+
+// returns the name of an order, as given on the command line
+const char *MeshOrderName(MeshOrder order)
+    { // MeshOrderName()
+    switch (order)
+        { // switch on order
+        case MESH_ORDER_FILE:
+            return "file";
+        case MESH_ORDER_UV:
+            return "uv";
+        case MESH_ORDER_OBJECT:
+            return "object";
+        } // switch on order
+    return "unknown";
+    } // MeshOrderName()
+
+// reorders the faces and attributes of the object
+void ReorderMesh(AttributedObject &object, MeshOrder order)
+    { // ReorderMesh()
+    if ((order == MESH_ORDER_FILE) || object.faceVertices.empty())
+        return;
+
+    // sort the faces along the curve
+    std::vector<FaceKey> keys;
+    FaceKeys(object, order, keys);
+    std::sort(keys.begin(), keys.end());
+    PermuteFaces(keys, object.faceVertices);
+    PermuteFaces(keys, object.faceColours);
+    PermuteFaces(keys, object.faceNormals);
+    PermuteFaces(keys, object.faceTexCoords);
+
+    // then number each attribute by first use
+    std::vector<unsigned int> newId;
+    FirstUseOrder(object.faceVertices, object.vertices.size(), newId);
+    Renumber(newId, object.vertices, object.faceVertices);
+
+    // Render looks colours up by vertex, so when there is one colour
+    // per vertex they are kept in step with the vertices
+    if (object.colours.size() != object.vertices.size())
+        FirstUseOrder(object.faceColours, object.colours.size(), newId);
+    Renumber(newId, object.colours, object.faceColours);
+
+    FirstUseOrder(object.faceNormals, object.normals.size(), newId);
+    Renumber(newId, object.normals, object.faceNormals);
+    FirstUseOrder(object.faceTexCoords, object.textureCoords.size(), newId);
+    Renumber(newId, object.textureCoords, object.faceTexCoords);
+    } // ReorderMesh()
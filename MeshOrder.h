@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshOrder.h
+//  ------------------------
+//
+//  Reorders the faces of an object so that faces near
+//  each other in memory are near each other in space,
+//  then renumbers the vertices & other attributes in
+//  the order the faces first use them.
+//
+//  Faces are sorted along a Morton (Z-order) curve
+//  through their centroids: in UV space for baking,
+//  where it keeps the texels a run of faces touches
+//  together, or in object space for rendering, where
+//  it keeps the vertices a run of faces fetches
+//  together.
+//
+///////////////////////////////////////////////////
+
+// include guard for MeshOrder
+#ifndef _MESH_ORDER_H
+#define _MESH_ORDER_H
+
+#include "AttributedObject.h"
+
+// the orders a mesh can be put in
+enum MeshOrder
+    { // enum MeshOrder
+    // as the faces came in the file
+    MESH_ORDER_FILE,
+    // along a curve through the texture coordinates
+    MESH_ORDER_UV,
+    // along a curve through the vertex positions
+    MESH_ORDER_OBJECT
+    }; // enum MeshOrder
+
+// returns the name of an order, as given on the command line
+const char *MeshOrderName(MeshOrder order);
+
+// reorders the faces and attributes of the object
+// (the mesh itself is unchanged, only the numbering)
+void ReorderMesh(AttributedObject &object, MeshOrder order);
+
+// end of include guard for MeshOrder
+#endif
@@ -0,0 +1,441 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshSimplifier.cpp
+//  ------------------------
+//
+//  Reduces a welded mesh by quadric-error half-edge
+//  collapses.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "MeshSimplifier.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <stdint.h>
+#include <vector>
+
+// marks the end of a corner list
+#define SIMPLIFY_NONE 0xFFFFFFFFu
+
+// a collapse is refused if it turns any face further than this (as a cosine)
+#define SIMPLIFY_MINIMUM_TURN 0.2
+
+// or if it moves the surface further than this fraction of the mesh's
+// size, measured as the root mean square distance to the original planes
+#define SIMPLIFY_MAXIMUM_ERROR 0.01
+
+// the squared distance to a set of planes, as a symmetric 4x4 matrix
+// stored as xx, xy, xz, xw, yy, yz, yw, zz, zw, ww
+struct Quadric
+    { // struct Quadric
+    double q[10];
+
+    Quadric()
+        { std::fill(q, q + 10, 0.0); }
+
+    // adds the plane n.p + d = 0, weighted
+    void AddPlane(double nx, double ny, double nz, double d, double weight)
+        { // AddPlane()
+        const double plane[4] = { nx, ny, nz, d };
+        int entry = 0;
+        for (int row = 0; row < 4; row++)
+            for (int column = row; column < 4; column++)
+                q[entry++] += weight * plane[row] * plane[column];
+        } // AddPlane()
+
+    void Add(const Quadric &other)
+        { // Add()
+        for (int entry = 0; entry < 10; entry++)
+            q[entry] += other.q[entry];
+        } // Add()
+
+    // the total weight of the planes
+    double Weight() const
+        { return q[0] + q[4] + q[7]; }
+
+    // the (weighted) error of a point
+    double Error(const float *p) const
+        { // Error()
+        double x = p[0], y = p[1], z = p[2];
+        return q[0]*x*x + 2.0*q[1]*x*y + 2.0*q[2]*x*z + 2.0*q[3]*x
+             + q[4]*y*y + 2.0*q[5]*y*z + 2.0*q[6]*y
+             + q[7]*z*z + 2.0*q[8]*z
+             + q[9];
+        } // Error()
+    }; // struct Quadric
+
+// a candidate collapse of one vertex onto another
+// quadrics only ever grow, so a cost can only go up after it was queued:
+// a candidate is checked when it comes off the queue, and queued again
+// at its new cost if it has gone stale
+struct Collapse
+    { // struct Collapse
+    float cost;
+    unsigned int from, to;
+
+    bool operator > (const Collapse &other) const
+        { return cost > other.cost; }
+    }; // struct Collapse
+
+// the working state of one simplification
+class Simplifier
+    { // class Simplifier
+    public:
+    Simplifier(const WeldedMesh &newMesh);
+
+    // collapses edges until at most targetTriangles faces are left
+    void Run(size_t targetTriangles);
+
+    // writes out the surviving faces, with their vertices renumbered
+    void Output(WeldedMesh &simplified) const;
+
+    private:
+    const WeldedMesh &mesh;
+
+    // the largest mean square error allowed
+    double maximumError;
+
+    // the faces as they are now, and which are still alive
+    std::vector<unsigned int> indices;
+    std::vector<unsigned char> faceAlive;
+    size_t liveFaces;
+
+    // each vertex's corners, as a linked list through nextCorner
+    std::vector<unsigned int> firstCorner, nextCorner;
+
+    // per vertex: error quadric, whether it may move, and whether it has gone
+    std::vector<Quadric> quadrics;
+    std::vector<unsigned char> locked, removed;
+
+    // the cheapest collapse first
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse> > queue;
+
+    // scratch space for TryCollapse(), kept to save reallocating it
+    std::vector<unsigned int> opposite, fromNeighbours, toNeighbours, shared, added;
+
+    const float *Position(unsigned int vertex) const
+        { return mesh.vertices[vertex].position; }
+
+    // the (unnormalized) normal of a triangle
+    void Normal(const float *a, const float *b, const float *c, double normal[3]) const;
+
+    // the vertices sharing a live face with a vertex, sorted & without repeats
+    void Neighbours(unsigned int vertex, std::vector<unsigned int> &neighbours) const;
+
+    // the cost of collapsing from onto to
+    float Cost(unsigned int from, unsigned int to) const;
+
+    // costs both directions of an edge and queues the cheaper one that is allowed
+    void QueueEdge(unsigned int a, unsigned int b);
+
+    // collapses from onto to, unless that would damage the mesh
+    // returns true if the collapse was made
+    bool TryCollapse(unsigned int from, unsigned int to);
+
+    // drops the corners of dead faces from a vertex's list
+    void CompactCorners(unsigned int vertex);
+    }; // class Simplifier
+
+// sets up quadrics, corner lists & the queue
+Simplifier::Simplifier(const WeldedMesh &newMesh)
+    : mesh(newMesh), indices(newMesh.indices),
+    faceAlive(newMesh.indices.size() / 3, 1), liveFaces(newMesh.indices.size() / 3),
+    firstCorner(newMesh.vertices.size(), SIMPLIFY_NONE), nextCorner(newMesh.indices.size(), SIMPLIFY_NONE),
+    quadrics(newMesh.vertices.size()), locked(newMesh.vertices.size(), 0),
+    removed(newMesh.vertices.size(), 0)
+    { // Simplifier()
+    // the size of the mesh is the diagonal of its bounding box
+    float lower[3] = { HUGE_VALF, HUGE_VALF, HUGE_VALF }, upper[3] = { -HUGE_VALF, -HUGE_VALF, -HUGE_VALF };
+    for (size_t vertex = 0; vertex < mesh.vertices.size(); vertex++)
+        for (int axis = 0; axis < 3; axis++)
+            { // per axis
+            lower[axis] = std::min(lower[axis], Position(vertex)[axis]);
+            upper[axis] = std::max(upper[axis], Position(vertex)[axis]);
+            } // per axis
+    double diagonal = 0.0;
+    for (int axis = 0; axis < 3; axis++)
+        if (upper[axis] > lower[axis])
+            diagonal += (double) (upper[axis] - lower[axis]) * (upper[axis] - lower[axis]);
+    maximumError = SIMPLIFY_MAXIMUM_ERROR * SIMPLIFY_MAXIMUM_ERROR * diagonal;
+
+    // corner lists, built backwards so each comes out in face order
+    for (size_t corner = indices.size(); corner-- > 0; )
+        { // per corner
+        nextCorner[corner] = firstCorner[indices[corner]];
+        firstCorner[indices[corner]] = (unsigned int) corner;
+        } // per corner
+
+    // each face adds its plane to its corners, weighted by its area
+    for (size_t face = 0; face < liveFaces; face++)
+        { // per face
+        const float *p = Position(indices[face*3]);
+        double normal[3];
+        Normal(p, Position(indices[face*3+1]), Position(indices[face*3+2]), normal);
+        double length = sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+        if (length == 0.0)
+            continue;
+        for (int axis = 0; axis < 3; axis++)
+            normal[axis] /= length;
+        double d = -(normal[0]*p[0] + normal[1]*p[1] + normal[2]*p[2]);
+        for (int vertex = 0; vertex < 3; vertex++)
+            quadrics[indices[face*3+vertex]].AddPlane(normal[0], normal[1], normal[2], d, 0.5 * length);
+        } // per face
+
+    // every edge, as (lower, higher), sorted so that repeats are adjacent
+    std::vector<uint64_t> edges(indices.size());
+    for (size_t face = 0; face < liveFaces; face++)
+        for (int vertex = 0; vertex < 3; vertex++)
+            { // per edge
+            uint64_t a = indices[face*3+vertex], b = indices[face*3+(vertex+1)%3];
+            edges[face*3+vertex] = (std::min(a, b) << 32) | std::max(a, b);
+            } // per edge
+    std::sort(edges.begin(), edges.end());
+
+    // an edge on one face is on a border or a seam, and one on three or more
+    // is non-manifold: either way its ends stay where they are
+    for (size_t edge = 0; edge < edges.size(); )
+        { // per distinct edge
+        size_t end = edge;
+        while ((end < edges.size()) && (edges[end] == edges[edge]))
+            end++;
+        unsigned int a = (unsigned int) (edges[edge] >> 32), b = (unsigned int) edges[edge];
+        if (end - edge != 2)
+            locked[a] = locked[b] = 1;
+        edge = end;
+        } // per distinct edge
+
+    // then queue every edge once the locks are known
+    for (size_t edge = 0; edge < edges.size(); edge++)
+        if ((edge == 0) || (edges[edge] != edges[edge - 1]))
+            QueueEdge((unsigned int) (edges[edge] >> 32), (unsigned int) edges[edge]);
+    } // Simplifier()
+
+// the cost of collapsing from onto to
+float Simplifier::Cost(unsigned int from, unsigned int to) const
+    { // Cost()
+    Quadric sum = quadrics[from];
+    sum.Add(quadrics[to]);
+    return (float) sum.Error(Position(to));
+    } // Cost()
+
+// the (unnormalized) normal of a triangle
+void Simplifier::Normal(const float *a, const float *b, const float *c, double normal[3]) const
+    { // Normal()
+    double u[3] = { (double) b[0] - a[0], (double) b[1] - a[1], (double) b[2] - a[2] };
+    double v[3] = { (double) c[0] - a[0], (double) c[1] - a[1], (double) c[2] - a[2] };
+    normal[0] = u[1]*v[2] - u[2]*v[1];
+    normal[1] = u[2]*v[0] - u[0]*v[2];
+    normal[2] = u[0]*v[1] - u[1]*v[0];
+    } // Normal()
+
+// the vertices sharing a live face with a vertex, sorted & without repeats
+void Simplifier::Neighbours(unsigned int vertex, std::vector<unsigned int> &neighbours) const
+    { // Neighbours()
+    neighbours.clear();
+    for (unsigned int corner = firstCorner[vertex]; corner != SIMPLIFY_NONE; corner = nextCorner[corner])
+        { // per corner
+        size_t face = corner / 3;
+        if (!faceAlive[face])
+            continue;
+        for (int other = 0; other < 3; other++)
+            if (indices[face*3+other] != vertex)
+                neighbours.push_back(indices[face*3+other]);
+        } // per corner
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    } // Neighbours()
+
+// costs both directions of an edge and queues the cheaper one that is allowed
+void Simplifier::QueueEdge(unsigned int a, unsigned int b)
+    { // QueueEdge()
+    if (locked[a] && locked[b])
+        return;
+
+    Collapse collapse;
+    collapse.cost = HUGE_VALF;
+    if (!locked[a])
+        { // a onto b
+        collapse.cost = Cost(a, b);
+        collapse.from = a;
+        collapse.to = b;
+        } // a onto b
+    if (!locked[b])
+        { // b onto a
+        float cost = Cost(b, a);
+        if (!(cost >= collapse.cost))
+            { // cheaper
+            collapse.cost = cost;
+            collapse.from = b;
+            collapse.to = a;
+            } // cheaper
+        } // b onto a
+    queue.push(collapse);
+    } // QueueEdge()
+
+// drops the corners of dead faces from a vertex's list
+void Simplifier::CompactCorners(unsigned int vertex)
+    { // CompactCorners()
+    unsigned int *link = &firstCorner[vertex];
+    while (*link != SIMPLIFY_NONE)
+        { // per corner
+        if (faceAlive[*link / 3])
+            link = &nextCorner[*link];
+        else
+            *link = nextCorner[*link];
+        } // per corner
+    } // CompactCorners()
+
+// collapses from onto to, unless that would damage the mesh
+bool Simplifier::TryCollapse(unsigned int from, unsigned int to)
+    { // TryCollapse()
+    // the faces on the edge go; the vertices opposite the edge in them
+    // must be the only neighbours the two ends share, or the surface pinches
+    opposite.clear();
+    for (unsigned int corner = firstCorner[from]; corner != SIMPLIFY_NONE; corner = nextCorner[corner])
+        { // per corner
+        size_t face = corner / 3;
+        if (!faceAlive[face])
+            continue;
+        const unsigned int *ids = &indices[face*3];
+        if ((ids[0] == to) || (ids[1] == to) || (ids[2] == to))
+            { // on the edge
+            for (int vertex = 0; vertex < 3; vertex++)
+                if ((ids[vertex] != from) && (ids[vertex] != to))
+                    opposite.push_back(ids[vertex]);
+            continue;
+            } // on the edge
+
+        // every other face of from moves: refuse if it folds over or vanishes
+        const float *p[3], *q[3];
+        for (int vertex = 0; vertex < 3; vertex++)
+            { // per vertex
+            p[vertex] = Position(ids[vertex]);
+            q[vertex] = (ids[vertex] == from) ? Position(to) : p[vertex];
+            } // per vertex
+        double before[3], after[3];
+        Normal(p[0], p[1], p[2], before);
+        Normal(q[0], q[1], q[2], after);
+        double dot = before[0]*after[0] + before[1]*after[1] + before[2]*after[2];
+        double lengths = sqrt((before[0]*before[0] + before[1]*before[1] + before[2]*before[2])
+                            * (after[0]*after[0] + after[1]*after[1] + after[2]*after[2]));
+        if (!(lengths > 0.0) || (dot < SIMPLIFY_MINIMUM_TURN * lengths))
+            return false;
+        } // per corner
+    if (opposite.empty())
+        return false;
+
+    std::sort(opposite.begin(), opposite.end());
+    opposite.erase(std::unique(opposite.begin(), opposite.end()), opposite.end());
+    shared.clear();
+    Neighbours(from, fromNeighbours);
+    Neighbours(to, toNeighbours);
+    std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(), toNeighbours.begin(), toNeighbours.end(),
+                          std::back_inserter(shared));
+    if (shared != opposite)
+        return false;
+
+    // kill the faces on the edge and move the rest onto to
+    unsigned int last = SIMPLIFY_NONE;
+    for (unsigned int corner = firstCorner[from]; corner != SIMPLIFY_NONE; corner = nextCorner[corner])
+        { // per corner
+        size_t face = corner / 3;
+        last = corner;
+        if (!faceAlive[face])
+            continue;
+        const unsigned int *ids = &indices[face*3];
+        if ((ids[0] == to) || (ids[1] == to) || (ids[2] == to))
+            { // on the edge
+            faceAlive[face] = 0;
+            liveFaces--;
+            } // on the edge
+        else
+            indices[corner] = to;
+        } // per corner
+
+    // from's corners now belong to to
+    if (last != SIMPLIFY_NONE)
+        { // splice
+        nextCorner[last] = firstCorner[to];
+        firstCorner[to] = firstCorner[from];
+        } // splice
+    firstCorner[from] = SIMPLIFY_NONE;
+    removed[from] = 1;
+    CompactCorners(to);
+
+    quadrics[to].Add(quadrics[from]);
+
+    // from's other neighbours are now joined to to by new edges
+    added.clear();
+    std::set_difference(fromNeighbours.begin(), fromNeighbours.end(), toNeighbours.begin(), toNeighbours.end(),
+                        std::back_inserter(added));
+    for (size_t neighbour = 0; neighbour < added.size(); neighbour++)
+        if (added[neighbour] != to)
+            QueueEdge(to, added[neighbour]);
+    return true;
+    } // TryCollapse()
+
+// collapses edges until at most targetTriangles faces are left
+void Simplifier::Run(size_t targetTriangles)
+    { // Run()
+    while ((liveFaces > targetTriangles) && !queue.empty())
+        { // per candidate
+        Collapse collapse = queue.top();
+        queue.pop();
+
+        // skip edges that have gone, and requeue those whose cost has grown
+        if (removed[collapse.from] || removed[collapse.to])
+            continue;
+        float cost = Cost(collapse.from, collapse.to);
+        if (cost > collapse.cost)
+            { // stale
+            collapse.cost = cost;
+            queue.push(collapse);
+            continue;
+            } // stale
+
+        // the cost is weighted by area, so divide that out before comparing
+        // (costs only grow, so a dropped edge is never worth trying again)
+        if (cost > maximumError * (quadrics[collapse.from].Weight() + quadrics[collapse.to].Weight()))
+            continue;
+        TryCollapse(collapse.from, collapse.to);
+        } // per candidate
+    } // Run()
+
+// writes out the surviving faces, with their vertices renumbered
+void Simplifier::Output(WeldedMesh &simplified) const
+    { // Output()
+    std::vector<unsigned int> newId(mesh.vertices.size(), SIMPLIFY_NONE);
+    simplified.vertices.clear();
+    simplified.vertices.reserve(std::count(removed.begin(), removed.end(), 0));
+    simplified.indices.clear();
+    simplified.indices.reserve(liveFaces * 3);
+    for (size_t face = 0; face < faceAlive.size(); face++)
+        { // per face
+        if (!faceAlive[face])
+            continue;
+        for (int vertex = 0; vertex < 3; vertex++)
+            { // per vertex
+            unsigned int id = indices[face*3+vertex];
+            if (newId[id] == SIMPLIFY_NONE)
+                { // first use
+                newId[id] = (unsigned int) simplified.vertices.size();
+                simplified.vertices.push_back(mesh.vertices[id]);
+                } // first use
+            simplified.indices.push_back(newId[id]);
+            } // per vertex
+        } // per face
+    } // Output()
+
+// simplifies a mesh to at most targetTriangles triangles, if it can
+void SimplifyMesh(const WeldedMesh &mesh, size_t targetTriangles, WeldedMesh &simplified)
+    { // SimplifyMesh()
+    Simplifier simplifier(mesh);
+    simplifier.Run(targetTriangles);
+    simplifier.Output(simplified);
+    } // SimplifyMesh()
@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  MeshSimplifier.h
+//  ------------------------
+//
+//  Reduces a welded mesh to fewer triangles by edge
+//  collapse, cheapest first, with the cost of each
+//  collapse measured by the quadric error metric of
+//  Garland & Heckbert.
+//
+//  Collapses are half-edge collapses: one end of the
+//  edge moves onto the other, so no new vertices (and
+//  no new colours, normals or texture coordinates)
+//  are invented.  Welding leaves the edges of UV and
+//  colour seams open, so vertices on open edges are
+//  never moved and the seams survive intact.
+//
+//  Collapses that would fold a face over, or pinch
+//  the surface into a non-manifold shape, are refused.
+//
+///////////////////////////////////////////////////
+
+// include guard for MeshSimplifier
+#ifndef _MESH_SIMPLIFIER_H
+#define _MESH_SIMPLIFIER_H
+
+#include <cstddef>
+
+#include "WeldedMesh.h"
+
+// simplifies a mesh to at most targetTriangles triangles, if it can
+// (it stops early if every remaining collapse is refused)
+// the vertices of the result are numbered in the order its faces use them
+void SimplifyMesh(const WeldedMesh &mesh, size_t targetTriangles, WeldedMesh &simplified);
+
+// end of include guard for MeshSimplifier
+#endif
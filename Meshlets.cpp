@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  Meshlets.cpp
+//  ------------------------
+//
+//  Splits a welded mesh into clusters of triangles
+//  that can be culled as a whole.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "Meshlets.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+// cones are widened by this much (as a cosine) against rounding
+#define MESHLET_CONE_SLACK 1.0e-3f
+
+// on a closed mesh, a cluster ends early at a face whose normal is
+// further than this (as a cosine, about 25 degrees) from the cluster's mean
+#define MESHLET_MINIMUM_COSINE 0.9
+
+// a mesh that reaches past the near plane by less than this (in clip
+// space) is taken to touch it, so a sphere scaled to just fill the depth
+// range is not undone by rounding
+#define MESHLET_NEAR_SLACK 1.0e-5f
+
+// the (unnormalized) normal of a face
+static void FaceNormal(const WeldedMesh &mesh, size_t face, double normal[3])
+    { // FaceNormal()
+    const float *a = mesh.vertices[mesh.indices[face*3]].position;
+    const float *b = mesh.vertices[mesh.indices[face*3+1]].position;
+    const float *c = mesh.vertices[mesh.indices[face*3+2]].position;
+    double u[3] = { (double) b[0] - a[0], (double) b[1] - a[1], (double) b[2] - a[2] };
+    double v[3] = { (double) c[0] - a[0], (double) c[1] - a[1], (double) c[2] - a[2] };
+    normal[0] = u[1]*v[2] - u[2]*v[1];
+    normal[1] = u[2]*v[0] - u[0]*v[2];
+    normal[2] = u[0]*v[1] - u[1]*v[0];
+    } // FaceNormal()
+
+// whether the mesh is closed & consistently wound, once vertices at the
+// same position are treated as one; if it is, sets outward to +1 if the
+// faces wind anticlockwise seen from outside, -1 if clockwise
+static bool IsClosed(const WeldedMesh &mesh, float &outward)
+    { // IsClosed()
+    // number the distinct positions: welding splits vertices along seams
+    std::vector<unsigned int> order(mesh.vertices.size());
+    for (size_t vertex = 0; vertex < order.size(); vertex++)
+        order[vertex] = (unsigned int) vertex;
+    std::sort(order.begin(), order.end(), [&mesh](unsigned int a, unsigned int b)
+        { // by position
+        const float *p = mesh.vertices[a].position, *q = mesh.vertices[b].position;
+        return std::lexicographical_compare(p, p + 3, q, q + 3);
+        }); // by position
+    std::vector<unsigned int> place(mesh.vertices.size());
+    unsigned int places = 0;
+    for (size_t rank = 0; rank < order.size(); rank++)
+        { // per vertex
+        if ((rank > 0) && !std::equal(mesh.vertices[order[rank]].position, mesh.vertices[order[rank]].position + 3,
+                                      mesh.vertices[order[rank - 1]].position))
+            places++;
+        place[order[rank]] = places;
+        } // per vertex
+
+    // every edge as (lower, higher) places, with the low bit set if the face runs it
+    // downwards; faces with two corners in one place (as at the poles of a sphere)
+    // cover nothing, and the two edges they have left cancel, so they are left out
+    std::vector<uint64_t> edges;
+    edges.reserve(mesh.indices.size());
+    for (size_t face = 0; face < mesh.indices.size() / 3; face++)
+        { // per face
+        uint64_t corners[3];
+        for (int corner = 0; corner < 3; corner++)
+            corners[corner] = place[mesh.indices[face * 3 + corner]];
+        if ((corners[0] == corners[1]) || (corners[1] == corners[2]) || (corners[2] == corners[0]))
+            continue;
+        for (int corner = 0; corner < 3; corner++)
+            { // per edge
+            uint64_t from = corners[corner], to = corners[(corner + 1) % 3];
+            edges.push_back((std::min(from, to) << 33) | (std::max(from, to) << 1) | (from > to ? 1 : 0));
+            } // per edge
+        } // per face
+    std::sort(edges.begin(), edges.end());
+
+    // closed & consistent: each edge is run exactly once each way
+    for (size_t edge = 0; edge < edges.size(); edge += 2)
+        if ((edge + 1 == edges.size()) || ((edges[edge] | 1) != edges[edge + 1]) || (edges[edge] & 1)
+            || ((edge + 2 < edges.size()) && ((edges[edge + 2] >> 1) == (edges[edge] >> 1))))
+            return false;
+
+    // the signed volume says which way the faces wind
+    double volume = 0.0;
+    for (size_t face = 0; face < mesh.indices.size() / 3; face++)
+        { // per face
+        double normal[3];
+        FaceNormal(mesh, face, normal);
+        const float *a = mesh.vertices[mesh.indices[face*3]].position;
+        volume += a[0]*normal[0] + a[1]*normal[1] + a[2]*normal[2];
+        } // per face
+    outward = (volume >= 0.0) ? 1.0f : -1.0f;
+    return true;
+    } // IsClosed()
+
+// where the cluster starting at a face ends: after MESHLET_TRIANGLES faces,
+// or earlier, on a closed mesh, at a face turned too far from the cluster's
+// mean normal (the Morton order jumps across the object now and then,
+// and a cone over both sides of it would never be culled)
+static size_t ClusterEnd(const WeldedMesh &mesh, size_t firstFace, bool closed)
+    { // ClusterEnd()
+    size_t endFace = std::min(firstFace + MESHLET_TRIANGLES, mesh.indices.size() / 3);
+    if (!closed)
+        return endFace;
+
+    double sum[3] = { 0.0, 0.0, 0.0 };
+    for (size_t face = firstFace; face < endFace; face++)
+        { // per face
+        double normal[3];
+        FaceNormal(mesh, face, normal);
+        double length = sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+        if (length == 0.0)
+            continue;
+        double sumLength = sqrt(sum[0]*sum[0] + sum[1]*sum[1] + sum[2]*sum[2]);
+        if ((sumLength > 0.0)
+            && ((normal[0]*sum[0] + normal[1]*sum[1] + normal[2]*sum[2]) < MESHLET_MINIMUM_COSINE * length * sumLength))
+            return face;
+        for (int axis = 0; axis < 3; axis++)
+            sum[axis] += normal[axis] / length;
+        } // per face
+    return endFace;
+    } // ClusterEnd()
+
+// builds the clusters of a mesh
+void BuildMeshlets(const WeldedMesh &mesh, std::vector<Meshlet> &meshlets)
+    { // BuildMeshlets()
+    float outward = 1.0f;
+    bool closed = IsClosed(mesh, outward);
+
+    size_t faces = mesh.indices.size() / 3;
+    meshlets.clear();
+    meshlets.reserve((faces + MESHLET_TRIANGLES - 1) / MESHLET_TRIANGLES);
+    for (size_t firstFace = 0, endFace = 0; firstFace < faces; firstFace = endFace)
+        { // per cluster
+        endFace = ClusterEnd(mesh, firstFace, closed);
+        Meshlet meshlet;
+        meshlet.firstIndex = (unsigned int) (firstFace * 3);
+        meshlet.indexCount = (unsigned int) ((endFace - firstFace) * 3);
+
+        // the sphere is centred on the bounding box
+        float lower[3] = { HUGE_VALF, HUGE_VALF, HUGE_VALF }, upper[3] = { -HUGE_VALF, -HUGE_VALF, -HUGE_VALF };
+        for (size_t index = firstFace * 3; index < endFace * 3; index++)
+            for (int axis = 0; axis < 3; axis++)
+                { // per axis
+                lower[axis] = std::min(lower[axis], mesh.vertices[mesh.indices[index]].position[axis]);
+                upper[axis] = std::max(upper[axis], mesh.vertices[mesh.indices[index]].position[axis]);
+                } // per axis
+        float squaredRadius = 0.0f;
+        for (int axis = 0; axis < 3; axis++)
+            meshlet.centre[axis] = 0.5f * (lower[axis] + upper[axis]);
+        for (size_t index = firstFace * 3; index < endFace * 3; index++)
+            { // per corner
+            const float *p = mesh.vertices[mesh.indices[index]].position;
+            float dx = p[0] - meshlet.centre[0], dy = p[1] - meshlet.centre[1], dz = p[2] - meshlet.centre[2];
+            squaredRadius = std::max(squaredRadius, dx*dx + dy*dy + dz*dz);
+            } // per corner
+        meshlet.radius = sqrtf(squaredRadius);
+
+        // the cone's axis is the mean of the unit normals, and it is as
+        // wide as the normal furthest from it
+        std::vector<double> normals;
+        double sum[3] = { 0.0, 0.0, 0.0 };
+        for (size_t face = firstFace; face < endFace; face++)
+            { // per face
+            double normal[3];
+            FaceNormal(mesh, face, normal);
+            double length = sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+            if (length == 0.0)
+                continue;
+            for (int axis = 0; axis < 3; axis++)
+                { // per axis
+                normals.push_back(outward * normal[axis] / length);
+                sum[axis] += normals.back();
+                } // per axis
+            } // per face
+        double sumLength = sqrt(sum[0]*sum[0] + sum[1]*sum[1] + sum[2]*sum[2]);
+        double minimumDot = -1.0;
+        if (closed && (sumLength > 0.0))
+            { // cone
+            minimumDot = 1.0;
+            for (size_t normal = 0; normal < normals.size(); normal += 3)
+                minimumDot = std::min(minimumDot, (normals[normal]*sum[0] + normals[normal+1]*sum[1] + normals[normal+2]*sum[2]) / sumLength);
+            minimumDot -= MESHLET_CONE_SLACK;
+            } // cone
+        for (int axis = 0; axis < 3; axis++)
+            meshlet.axis[axis] = (sumLength > 0.0) ? (float) (sum[axis] / sumLength) : 0.0f;
+        meshlet.spread = (minimumDot > 0.0) ? (float) sqrt(1.0 - minimumDot * minimumDot) : 1.0f;
+
+        meshlets.push_back(meshlet);
+        } // per cluster
+    } // BuildMeshlets()
+
+// one coordinate of a point in clip space
+static float ClipCoordinate(const float clip[16], const float point[3], int row)
+    { // ClipCoordinate()
+    return clip[row] * point[0] + clip[4+row] * point[1] + clip[8+row] * point[2] + clip[12+row];
+    } // ClipCoordinate()
+
+// the index ranges to draw, skipping clusters that face away from the viewer
+// or lie outside the view volume, with neighbouring clusters merged
+void VisibleMeshletRuns(const std::vector<Meshlet> &meshlets, const float meshCentre[3], float meshRadius,
+                        const float modelView[16], const float projection[16], unsigned int indexLimit,
+                        std::vector<unsigned int> &firstIndices, std::vector<unsigned int> &indexCounts)
+    { // VisibleMeshletRuns()
+    firstIndices.clear();
+    indexCounts.clear();
+
+    // the viewer looks down the eye's -z axis, so towards the viewer is the
+    // eye's z axis, which in object space is the third row of the model-view
+    float toViewer[3] = { modelView[2], modelView[6], modelView[10] };
+    float length = sqrtf(toViewer[0]*toViewer[0] + toViewer[1]*toViewer[1] + toViewer[2]*toViewer[2]);
+    if (length > 0.0f)
+        for (int axis = 0; axis < 3; axis++)
+            toViewer[axis] /= length;
+
+    // object space to clip space; with an orthographic projection w stays 1,
+    // and a sphere's reach along each clip axis is its radius times the row's length
+    float clip[16];
+    for (int column = 0; column < 4; column++)
+        for (int row = 0; row < 4; row++)
+            { // per entry
+            clip[column*4+row] = 0.0f;
+            for (int term = 0; term < 4; term++)
+                clip[column*4+row] += projection[term*4+row] * modelView[column*4+term];
+            } // per entry
+    float reach[3];
+    for (int row = 0; row < 3; row++)
+        reach[row] = sqrtf(clip[row]*clip[row] + clip[4+row]*clip[4+row] + clip[8+row]*clip[8+row]);
+
+    // if the near plane cuts into the object, its inside shows, so back faces must stay
+    bool cullBackFaces = ClipCoordinate(clip, meshCentre, 2) - meshRadius * reach[2] >= -1.0f - MESHLET_NEAR_SLACK;
+
+    for (size_t cluster = 0; cluster < meshlets.size(); cluster++)
+        { // per cluster
+        const Meshlet &meshlet = meshlets[cluster];
+        if (meshlet.firstIndex >= indexLimit)
+            break;
+
+        // facing wholly away
+        if (cullBackFaces && (meshlet.axis[0]*toViewer[0] + meshlet.axis[1]*toViewer[1] + meshlet.axis[2]*toViewer[2] < -meshlet.spread))
+            continue;
+
+        // wholly outside the view volume
+        bool outside = false;
+        for (int row = 0; (row < 3) && !outside; row++)
+            { // per clip axis
+            float centre = ClipCoordinate(clip, meshlet.centre, row);
+            float extent = meshlet.radius * reach[row];
+            outside = (centre - extent > 1.0f) || (centre + extent < -1.0f);
+            } // per clip axis
+        if (outside)
+            continue;
+
+        // joins on to the previous run if it follows straight on
+        unsigned int count = std::min(meshlet.indexCount, indexLimit - meshlet.firstIndex);
+        if (!firstIndices.empty() && (firstIndices.back() + indexCounts.back() == meshlet.firstIndex))
+            indexCounts.back() += count;
+        else
+            { // new run
+            firstIndices.push_back(meshlet.firstIndex);
+            indexCounts.push_back(count);
+            } // new run
+        } // per cluster
+    } // VisibleMeshletRuns()
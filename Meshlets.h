@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  Meshlets.h
+//  ------------------------
+//
+//  Splits a welded mesh into clusters of consecutive
+//  triangles, each with a bounding sphere and a cone
+//  holding all its face normals, so that a cluster
+//  facing wholly away from the viewer, or wholly out
+//  of view, can be skipped without looking at its
+//  triangles.
+//
+//  The faces are already sorted along a Morton curve
+//  through object space, so a run of consecutive
+//  faces is usually a compact patch of surface and
+//  its cone is narrow.  Where the order jumps to the far side
+//  of a cell, the cluster is cut short instead.
+//  Clusters are ranges of the index buffer, so
+//  nothing is reordered or copied.
+//
+//  Skipping back faces is only safe when nothing can
+//  be seen through the surface, so cones are only
+//  made for closed meshes: those where every edge,
+//  matched by the positions of its ends, is shared
+//  by exactly two faces that wind it in opposite
+//  directions.  Other meshes get clusters that are
+//  only tested against the view volume.  Clusters
+//  are never skipped as back faces while the near
+//  plane cuts into the object, as the inside of the
+//  surface then shows.
+//
+///////////////////////////////////////////////////
+
+// include guard for Meshlets
+#ifndef _MESHLETS_H
+#define _MESHLETS_H
+
+#include <vector>
+
+#include "WeldedMesh.h"
+
+// most triangles per cluster
+#define MESHLET_TRIANGLES 256
+
+// one cluster of faces
+struct Meshlet
+    { // struct Meshlet
+    // the cluster's range of the index buffer
+    unsigned int firstIndex, indexCount;
+
+    // a sphere holding every vertex
+    float centre[3], radius;
+
+    // the mean outward normal, and the sine of the angle from it to
+    // the furthest face normal: every face points away from a viewer
+    // in direction v (unit, object space) if axis.v < -spread
+    // (spread is 1 if the normals span a hemisphere or more, or the
+    // mesh is not closed)
+    float axis[3], spread;
+    }; // struct Meshlet
+
+// builds the clusters of a mesh
+void BuildMeshlets(const WeldedMesh &mesh, std::vector<Meshlet> &meshlets);
+
+// the index ranges to draw, skipping clusters that face away from the viewer
+// or lie outside the view volume, with neighbouring clusters merged
+// the matrices are OpenGL's (column-major), and the projection must be orthographic
+// the sphere holds the whole mesh, and says whether the near plane cuts into it
+// only the first indexLimit indices are used
+void VisibleMeshletRuns(const std::vector<Meshlet> &meshlets, const float meshCentre[3], float meshRadius,
+                        const float modelView[16], const float projection[16], unsigned int indexLimit,
+                        std::vector<unsigned int> &firstIndices, std::vector<unsigned int> &indexCounts);
+
+// end of include guard for Meshlets
+#endif
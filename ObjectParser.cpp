@@ -0,0 +1,690 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ObjectParser.cpp
+//  ------------------------
+//
+//  Parses the text of an OBJ file held in memory, in
+//  chunks on several threads.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "ObjectParser.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <locale.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// local includes
+#include "WorkStealing.h"
+
+// the text is cut into this many chunks per thread
+#define PARSE_CHUNKS_PER_THREAD 4
+
+// but no chunk is smaller than this (in bytes)
+#define PARSE_MINIMUM_CHUNK (1 << 20)
+
+// streams are read in blocks of this size
+#define STREAM_BLOCK_SIZE (1 << 20)
+
+// and parsed in pieces of at least this size (in bytes) as they are read
+#define PARSE_STREAM_CHUNK (1 << 22)
+
+// numbers shorter than this are copied onto the stack for the slow path
+#define MAXIMUM_NUMBER_LENGTH 64
+
+// the kinds of line we care about
+enum LineKind
+    { // enum LineKind
+    LINE_OTHER,
+    LINE_VERTEX,
+    LINE_COLOUR,
+    LINE_NORMAL,
+    LINE_TEX_COORD,
+    LINE_FACE
+    }; // enum LineKind
+
+// powers of ten that are exact in a float
+static const float exactPowersOfTen[] =
+    {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+// true for the spaces that separate values on a line
+static inline bool IsBlank(char c)
+    { // IsBlank()
+    return (c == ' ') || (c == '\t') || (c == '\r');
+    } // IsBlank()
+
+// true for a decimal digit
+static inline bool IsDigit(char c)
+    { // IsDigit()
+    return (unsigned char) (c - '0') < 10;
+    } // IsDigit()
+
+// the end of the line starting at line: the newline, or the end of the text
+static inline const char *LineEnd(const char *line, const char *end)
+    { // LineEnd()
+    const char *newline = (const char *) memchr(line, '\n', end - line);
+    return (newline == NULL) ? end : newline;
+    } // LineEnd()
+
+// classifies a line by its keyword, and moves past the keyword
+static inline LineKind Classify(const char *&cursor, const char *lineEnd)
+    { // Classify()
+    while ((cursor < lineEnd) && IsBlank(*cursor))
+        cursor++;
+
+    // keywords are one or two characters followed by a blank
+    size_t length = lineEnd - cursor;
+    if ((length < 2) || ((cursor[0] != 'v') && (cursor[0] != 'f')))
+        return LINE_OTHER;
+    if (IsBlank(cursor[1]))
+        { // one character
+        cursor++;
+        return (cursor[-1] == 'v') ? LINE_VERTEX : LINE_FACE;
+        } // one character
+    if ((cursor[0] != 'v') || (length < 3) || !IsBlank(cursor[2]))
+        return LINE_OTHER;
+
+    LineKind kind = LINE_OTHER;
+    switch (cursor[1])
+        { // switch on second character
+        case 'c':
+            kind = LINE_COLOUR;
+            break;
+        case 'n':
+            kind = LINE_NORMAL;
+            break;
+        case 't':
+            kind = LINE_TEX_COORD;
+            break;
+        } // switch on second character
+    if (kind != LINE_OTHER)
+        cursor += 2;
+    return kind;
+    } // Classify()
+
+// parses a decimal number such as -1.25e-3 at the cursor, skipping blanks before it
+// returns false, leaving the cursor alone, if there is no number there
+static bool ParseFloat(const char *&cursor, const char *lineEnd, float &value)
+    { // ParseFloat()
+    const char *p = cursor;
+    while ((p < lineEnd) && IsBlank(*p))
+        p++;
+    const char *start = p;
+
+    bool negative = false;
+    if ((p < lineEnd) && ((*p == '-') || (*p == '+')))
+        negative = (*p++ == '-');
+
+    // up to 19 significant digits fit in 64 bits; later ones only scale
+    uint64_t mantissa = 0;
+    int significant = 0, exponent = 0;
+    bool anyDigits = false;
+    for ( ; (p < lineEnd) && IsDigit(*p); p++, anyDigits = true)
+        if (significant < 19)
+            { // keep the digit
+            mantissa = mantissa * 10 + (*p - '0');
+            significant += (mantissa != 0);
+            } // keep the digit
+        else
+            exponent++;
+    if ((p < lineEnd) && (*p == '.'))
+        for (p++; (p < lineEnd) && IsDigit(*p); p++, anyDigits = true)
+            if (significant < 19)
+                { // keep the digit
+                mantissa = mantissa * 10 + (*p - '0');
+                significant += (mantissa != 0);
+                exponent--;
+                } // keep the digit
+    if (!anyDigits)
+        return false;
+
+    if ((p < lineEnd) && ((*p == 'e') || (*p == 'E')))
+        { // exponent
+        const char *e = p + 1;
+        bool negativeExponent = false;
+        if ((e < lineEnd) && ((*e == '-') || (*e == '+')))
+            negativeExponent = (*e++ == '-');
+        if ((e < lineEnd) && IsDigit(*e))
+            { // has digits
+            int written = 0;
+            for ( ; (e < lineEnd) && IsDigit(*e); e++)
+                if (written < 10000)
+                    written = written * 10 + (*e - '0');
+            exponent += negativeExponent ? -written : written;
+            p = e;
+            } // has digits
+        } // exponent
+
+    // with at most 7 digits (exact in a float) and a small exponent, one
+    // correctly rounded float multiply or divide gives the right answer;
+    // otherwise ask the C library, in the C locale since Qt sets the user's
+    // (which may want a comma for the decimal point)
+    float result;
+    if ((significant <= 7) && (exponent >= -10) && (exponent <= 10))
+        { // fast path
+        result = (float) mantissa;
+        result = (exponent < 0) ? result / exactPowersOfTen[-exponent] : result * exactPowersOfTen[exponent];
+        if (negative)
+            result = -result;
+        } // fast path
+    else
+        { // slow path
+        // strtof needs the number on its own, so copy it out: on the stack
+        // when it fits, which is nearly always, or else whole onto the heap
+        static const locale_t cLocale = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
+        size_t length = (size_t) (p - start);
+        if (length < MAXIMUM_NUMBER_LENGTH)
+            { // short number
+            char number[MAXIMUM_NUMBER_LENGTH];
+            memcpy(number, start, length);
+            number[length] = '\0';
+            result = strtof_l(number, NULL, cLocale);
+            } // short number
+        else
+            { // long number
+            std::string number(start, length);
+            result = strtof_l(number.c_str(), NULL, cLocale);
+            } // long number
+        } // slow path
+
+    value = result;
+    cursor = p;
+    return true;
+    } // ParseFloat()
+
+// parses a signed decimal integer at the cursor, without skipping anything
+// returns false, leaving the cursor alone, if there are no digits
+static inline bool ParseIndex(const char *&cursor, const char *lineEnd, int64_t &value)
+    { // ParseIndex()
+    const char *p = cursor;
+    bool negative = (p < lineEnd) && (*p == '-');
+    if (negative)
+        p++;
+    const char *digits = p;
+    int64_t result = 0;
+    for ( ; (p < lineEnd) && IsDigit(*p); p++)
+        if (result < ((int64_t) 1 << 40))
+            result = result * 10 + (*p - '0');
+    if (p == digits)
+        return false;
+    value = negative ? -result : result;
+    cursor = p;
+    return true;
+    } // ParseIndex()
+
+// parses up to three coordinates, leaving any that are missing at zero
+static inline Cartesian3 ParseTriple(const char *cursor, const char *lineEnd)
+    { // ParseTriple()
+    float xyz[3] = { 0.0f, 0.0f, 0.0f };
+    for (int component = 0; component < 3; component++)
+        if (!ParseFloat(cursor, lineEnd, xyz[component]))
+            break;
+    return Cartesian3(xyz[0], xyz[1], xyz[2]);
+    } // ParseTriple()
+
+// one piece of the text, parsed by one thread
+struct ParseChunk
+    { // struct ParseChunk
+    // the text, which starts at the start of a line
+    const char *begin, *end;
+    // the number of lines of each kind in the chunk
+    size_t counts[LINE_FACE + 1];
+    // and in all the chunks before it: where its lines go in the arrays
+    size_t starts[LINE_FACE + 1];
+    // the first line that failed to parse, if any
+    const char *badLine;
+    }; // struct ParseChunk
+
+// the attribute arrays a face corner indexes, in the order they are written
+static const LineKind cornerKinds[4] = { LINE_VERTEX, LINE_COLOUR, LINE_TEX_COORD, LINE_NORMAL };
+
+// parses a triangle of vertex/colour/texcoord/normal corners into the zero-based ids
+// seen[k] is the number of lines of kind k before this one, which negative
+// (relative) indices count back from.  returns false if the line is malformed
+static bool ParseFace(const char *cursor, const char *lineEnd, const size_t seen[LINE_FACE + 1], unsigned int ids[3][4])
+    { // ParseFace()
+    for (int vertex = 0; vertex < 3; vertex++)
+        { // per vertex
+        while ((cursor < lineEnd) && IsBlank(*cursor))
+            cursor++;
+        for (int attribute = 0; attribute < 4; attribute++)
+            { // per attribute
+            if ((attribute > 0) && ((cursor == lineEnd) || (*cursor++ != '/')))
+                return false;
+            int64_t index;
+            if (!ParseIndex(cursor, lineEnd, index))
+                return false;
+
+            // OBJ counts from 1, or back from -1 for the latest, so 0 is never valid
+            int64_t id = (index > 0) ? index - 1 : (int64_t) seen[cornerKinds[attribute]] + index;
+            if ((index == 0) || (id < 0) || (id > 0xFFFFFFFFLL))
+                return false;
+            ids[vertex][attribute] = (unsigned int) id;
+            } // per attribute
+        } // per vertex
+    return true;
+    } // ParseFace()
+
+// counting pass over a chunk
+static void CountChunk(ParseChunk &chunk)
+    { // CountChunk()
+    for (int kind = 0; kind <= LINE_FACE; kind++)
+        chunk.counts[kind] = 0;
+    for (const char *line = chunk.begin; line < chunk.end; )
+        { // per line
+        const char *lineEnd = LineEnd(line, chunk.end);
+        const char *cursor = line;
+        chunk.counts[Classify(cursor, lineEnd)]++;
+        line = lineEnd + 1;
+        } // per line
+    } // CountChunk()
+
+// parsing pass over a chunk, writing straight to its place in the arrays
+// bases[k] is the number of the line of kind k that goes first in the object's
+// arrays: zero when they hold the whole file, the chunk's starts when they
+// hold the chunk alone
+static void ParseChunkText(ParseChunk &chunk, AttributedObject &object, const size_t bases[LINE_FACE + 1])
+    { // ParseChunkText()
+    // seen counts lines from the start of the file
+    size_t seen[LINE_FACE + 1];
+    for (int kind = 0; kind <= LINE_FACE; kind++)
+        seen[kind] = chunk.starts[kind];
+
+    for (const char *line = chunk.begin; line < chunk.end; )
+        { // per line
+        const char *lineEnd = LineEnd(line, chunk.end);
+        const char *cursor = line;
+        LineKind kind = Classify(cursor, lineEnd);
+        switch (kind)
+            { // switch on kind
+            case LINE_VERTEX:
+                object.vertices[seen[kind] - bases[kind]] = ParseTriple(cursor, lineEnd);
+                break;
+            case LINE_COLOUR:
+                object.colours[seen[kind] - bases[kind]] = ParseTriple(cursor, lineEnd);
+                break;
+            case LINE_NORMAL:
+                object.normals[seen[kind] - bases[kind]] = ParseTriple(cursor, lineEnd);
+                break;
+            case LINE_TEX_COORD:
+                object.textureCoords[seen[kind] - bases[kind]] = ParseTriple(cursor, lineEnd);
+                break;
+            case LINE_FACE:
+                { // face
+                unsigned int ids[3][4];
+                if (!ParseFace(cursor, lineEnd, seen, ids))
+                    { // bad face
+                    chunk.badLine = line;
+                    return;
+                    } // bad face
+                for (int vertex = 0; vertex < 3; vertex++)
+                    { // per vertex
+                    size_t corner = (seen[kind] - bases[kind]) * 3 + vertex;
+                    object.faceVertices[corner] = ids[vertex][0];
+                    object.faceColours[corner] = ids[vertex][1];
+                    object.faceTexCoords[corner] = ids[vertex][2];
+                    object.faceNormals[corner] = ids[vertex][3];
+                    } // per vertex
+                break;
+                } // face
+            case LINE_OTHER:
+                // comments, groups, materials &c. are ignored
+                break;
+            } // switch on kind
+        seen[kind]++;
+        line = lineEnd + 1;
+        } // per line
+    } // ParseChunkText()
+
+// sizes every array for the given number of lines of each kind, allocating each once
+static void SizeArrays(AttributedObject &object, const size_t counts[LINE_FACE + 1])
+    { // SizeArrays()
+    object.vertices.assign(counts[LINE_VERTEX], Cartesian3());
+    object.colours.assign(counts[LINE_COLOUR], Cartesian3());
+    object.normals.assign(counts[LINE_NORMAL], Cartesian3());
+    object.textureCoords.assign(counts[LINE_TEX_COORD], Cartesian3());
+    object.faceVertices.assign(counts[LINE_FACE] * 3, 0);
+    object.faceColours.assign(counts[LINE_FACE] * 3, 0);
+    object.faceNormals.assign(counts[LINE_FACE] * 3, 0);
+    object.faceTexCoords.assign(counts[LINE_FACE] * 3, 0);
+    } // SizeArrays()
+
+// checks that every corner refers to attributes that exist
+// returns false (after saying which face does not) if one does not
+static bool CheckCorners(const AttributedObject &object)
+    { // CheckCorners()
+    for (size_t corner = 0; corner < object.faceVertices.size(); corner++)
+        if ((object.faceVertices[corner] >= object.vertices.size()) || (object.faceColours[corner] >= object.colours.size())
+            || (object.faceTexCoords[corner] >= object.textureCoords.size()) || (object.faceNormals[corner] >= object.normals.size()))
+            { // out of range
+            std::cout << "Face " << corner / 3 << " refers to a missing vertex attribute" << std::endl;
+            return false;
+            } // out of range
+    return true;
+    } // CheckCorners()
+
+// parses the OBJ text in [begin, end) into the object's vertex & face arrays
+// using the given number of threads (0 for one per core)
+// returns false (after printing the offending line) if a face is malformed
+bool ParseObject(const char *begin, const char *end, AttributedObject &object, int threads)
+    { // ParseObject()
+    if (threads <= 0)
+        threads = DefaultThreadCount();
+
+    // cut the text into a few chunks per thread, so that stealing can even out
+    // the load, but none so small that the threads cost more than they save
+    size_t bytes = end - begin;
+    size_t nChunks = std::min((size_t) threads * PARSE_CHUNKS_PER_THREAD, bytes / PARSE_MINIMUM_CHUNK + 1);
+    std::vector<ParseChunk> chunks(nChunks);
+    const char *chunkBegin = begin;
+    for (size_t chunk = 0; chunk < nChunks; chunk++)
+        { // per chunk
+        // each chunk ends just after the first newline past its share of the text
+        const char *chunkEnd = (chunk + 1 == nChunks) ? end : begin + bytes * (chunk + 1) / nChunks;
+        if (chunkEnd < chunkBegin)
+            chunkEnd = chunkBegin;
+        if (chunkEnd < end)
+            chunkEnd = std::min(LineEnd(chunkEnd, end) + 1, end);
+        chunks[chunk].begin = chunkBegin;
+        chunks[chunk].end = chunkEnd;
+        chunks[chunk].badLine = NULL;
+        chunkBegin = chunkEnd;
+        } // per chunk
+
+    // counting pass: how many lines of each kind there are in each chunk
+    RunWorkStealing((int) nChunks, threads, [&](int, int chunk)
+        { // per chunk
+        CountChunk(chunks[chunk]);
+        }); // per chunk
+
+    // prefix sum gives each chunk's offset into every array
+    size_t totals[LINE_FACE + 1] = { 0, 0, 0, 0, 0, 0 };
+    for (size_t chunk = 0; chunk < nChunks; chunk++)
+        for (int kind = 0; kind <= LINE_FACE; kind++)
+            { // per kind
+            chunks[chunk].starts[kind] = totals[kind];
+            totals[kind] += chunks[chunk].counts[kind];
+            } // per kind
+
+    // so that every array is allocated exactly once, at its final size
+    SizeArrays(object, totals);
+
+    // parsing pass: the chunks write to disjoint parts of the arrays
+    const size_t bases[LINE_FACE + 1] = { 0, 0, 0, 0, 0, 0 };
+    RunWorkStealing((int) nChunks, threads, [&](int, int chunk)
+        { // per chunk
+        ParseChunkText(chunks[chunk], object, bases);
+        }); // per chunk
+
+    // report the first bad line in the file
+    for (size_t chunk = 0; chunk < nChunks; chunk++)
+        if (chunks[chunk].badLine != NULL)
+            { // bad face
+            std::cout << "Malformed face: " << std::string(chunks[chunk].badLine, LineEnd(chunks[chunk].badLine, end)) << std::endl;
+            return false;
+            } // bad face
+
+    // every corner must refer to attributes that exist
+    return CheckCorners(object);
+    } // ParseObject()
+
+// one piece of a file being read, with its own copy of the text and arrays
+// for its lines, so that it can be parsed while later pieces are still read
+struct StreamChunk
+    { // struct StreamChunk
+    std::vector<char> text;
+    ParseChunk chunk;
+    AttributedObject part;
+    std::thread thread;
+    }; // struct StreamChunk
+
+// copies one piece's array into its place in the whole array
+template <class Element> static void CopyPart(const std::vector<Element> &part, std::vector<Element> &whole, size_t start)
+    { // CopyPart()
+    std::copy(part.begin(), part.end(), whole.begin() + start);
+    } // CopyPart()
+
+// reads OBJ text from a file or pipe, parsing each piece on a thread of its own
+// as soon as it has been read, so that reading overlaps with parsing
+// returns false (after printing the offending line) if a face is malformed,
+// or if the input cannot be read
+bool ParseObjectFile(FILE *file, AttributedObject &object, int threads)
+    { // ParseObjectFile()
+    if (threads <= 0)
+        threads = DefaultThreadCount();
+
+    // the pieces stay where they are as more are added
+    std::deque<StreamChunk> chunks;
+    size_t joined = 0;
+    size_t totals[LINE_FACE + 1] = { 0, 0, 0, 0, 0, 0 };
+
+    // the start of a line that was cut off by the end of the previous piece
+    std::vector<char> carry;
+    bool endOfFile = false;
+    while (!endOfFile)
+        { // per piece
+        // read until there is enough text, then hold back the unfinished last line
+        std::vector<char> text;
+        text.swap(carry);
+        size_t used = text.size(), complete = 0;
+        while ((used < PARSE_STREAM_CHUNK) || (complete == 0))
+            { // per block
+            text.resize(used + STREAM_BLOCK_SIZE);
+            size_t got = fread(&text[used], 1, STREAM_BLOCK_SIZE, file);
+            if (got == 0)
+                { // end of input
+                endOfFile = true;
+                complete = used;
+                break;
+                } // end of input
+            for (size_t byte = used + got; byte > used; byte--)
+                if (text[byte - 1] == '\n')
+                    { // last newline
+                    complete = byte;
+                    break;
+                    } // last newline
+            used += got;
+            } // per block
+        carry.assign(text.begin() + complete, text.begin() + used);
+        text.resize(complete);
+        if (text.empty())
+            continue;
+
+        // the counts of the pieces before say where this one's lines go
+        chunks.push_back(StreamChunk());
+        StreamChunk &piece = chunks.back();
+        piece.text.swap(text);
+        piece.chunk.begin = piece.text.data();
+        piece.chunk.end = piece.text.data() + piece.text.size();
+        piece.chunk.badLine = NULL;
+        CountChunk(piece.chunk);
+        for (int kind = 0; kind <= LINE_FACE; kind++)
+            { // per kind
+            piece.chunk.starts[kind] = totals[kind];
+            totals[kind] += piece.chunk.counts[kind];
+            } // per kind
+
+        // parse it on a thread of its own, once there is a thread to spare
+        if (chunks.size() - joined > (size_t) threads)
+            chunks[joined++].thread.join();
+        piece.thread = std::thread([&piece]()
+            { // parse piece
+            SizeArrays(piece.part, piece.chunk.counts);
+            ParseChunkText(piece.chunk, piece.part, piece.chunk.starts);
+            // the text is only needed to report a bad line
+            if (piece.chunk.badLine == NULL)
+                std::vector<char>().swap(piece.text);
+            }); // parse piece
+        } // per piece
+    for ( ; joined < chunks.size(); joined++)
+        chunks[joined].thread.join();
+
+    if (ferror(file))
+        { // unreadable
+        std::cout << "Could not read the model" << std::endl;
+        return false;
+        } // unreadable
+
+    // report the first bad line in the file
+    for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+        if (chunks[chunk].chunk.badLine != NULL)
+            { // bad face
+            std::cout << "Malformed face: " << std::string(chunks[chunk].chunk.badLine, LineEnd(chunks[chunk].chunk.badLine, chunks[chunk].chunk.end)) << std::endl;
+            return false;
+            } // bad face
+
+    // gather the pieces into the object, letting each go once it is copied
+    SizeArrays(object, totals);
+    for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+        { // per chunk
+        const size_t *starts = chunks[chunk].chunk.starts;
+        AttributedObject &part = chunks[chunk].part;
+        CopyPart(part.vertices, object.vertices, starts[LINE_VERTEX]);
+        CopyPart(part.colours, object.colours, starts[LINE_COLOUR]);
+        CopyPart(part.normals, object.normals, starts[LINE_NORMAL]);
+        CopyPart(part.textureCoords, object.textureCoords, starts[LINE_TEX_COORD]);
+        CopyPart(part.faceVertices, object.faceVertices, starts[LINE_FACE] * 3);
+        CopyPart(part.faceColours, object.faceColours, starts[LINE_FACE] * 3);
+        CopyPart(part.faceNormals, object.faceNormals, starts[LINE_FACE] * 3);
+        CopyPart(part.faceTexCoords, object.faceTexCoords, starts[LINE_FACE] * 3);
+        part = AttributedObject();
+        } // per chunk
+
+    // every corner must refer to attributes that exist
+    return CheckCorners(object);
+    } // ParseObjectFile()
+
+// constructor reads from an open file, which the caller closes
+ObjectStreamParser::ObjectStreamParser(FILE *newFile)
+    : faceCount(0), file(newFile), endOfFile(false),
+    text(STREAM_BLOCK_SIZE), textBegin(0), textEnd(0),
+    vertexCount(0)
+    { // ObjectStreamParser()
+    } // ObjectStreamParser()
+
+// parses one line, adding any face to the batch; returns false if it is malformed
+bool ObjectStreamParser::ParseLine(const char *line, const char *lineEnd, AttributedObject &batch)
+    { // ParseLine()
+    const char *cursor = line;
+    switch (Classify(cursor, lineEnd))
+        { // switch on kind
+        case LINE_VERTEX:
+            vertexCount++;
+            break;
+        case LINE_COLOUR:
+            colours.push_back(ParseTriple(cursor, lineEnd));
+            break;
+        case LINE_NORMAL:
+            normals.push_back(ParseTriple(cursor, lineEnd));
+            break;
+        case LINE_TEX_COORD:
+            textureCoords.push_back(ParseTriple(cursor, lineEnd));
+            break;
+        case LINE_FACE:
+            { // face
+            size_t seen[LINE_FACE + 1] = { 0, vertexCount, colours.size(), normals.size(), textureCoords.size(), faceCount };
+            unsigned int ids[3][4];
+            if (!ParseFace(cursor, lineEnd, seen, ids))
+                { // bad face
+                std::cout << "Malformed face: " << std::string(line, lineEnd) << std::endl;
+                return false;
+                } // bad face
+
+            // copy the corners' attributes into the batch, so that it stands alone
+            for (int vertex = 0; vertex < 3; vertex++)
+                { // per vertex
+                if ((ids[vertex][0] >= vertexCount) || (ids[vertex][1] >= colours.size())
+                    || (ids[vertex][2] >= textureCoords.size()) || (ids[vertex][3] >= normals.size()))
+                    { // forward reference
+                    std::cout << "Face " << faceCount << " refers to a vertex attribute not yet defined" << std::endl;
+                    return false;
+                    } // forward reference
+                unsigned int corner = (unsigned int) batch.faceTexCoords.size();
+                batch.colours.push_back(colours[ids[vertex][1]]);
+                batch.textureCoords.push_back(textureCoords[ids[vertex][2]]);
+                batch.normals.push_back(normals[ids[vertex][3]]);
+                batch.faceColours.push_back(corner);
+                batch.faceTexCoords.push_back(corner);
+                batch.faceNormals.push_back(corner);
+                } // per vertex
+            faceCount++;
+            break;
+            } // face
+        case LINE_OTHER:
+            // comments, groups, materials &c. are ignored
+            break;
+        } // switch on kind
+    return true;
+    } // ParseLine()
+
+// fills batch with up to maxFaces faces, each corner with attributes of its own
+// returns false if the input is malformed or unreadable
+// the batch comes back empty once the input is used up
+bool ObjectStreamParser::NextBatch(size_t maxFaces, AttributedObject &batch)
+    { // NextBatch()
+    batch.vertices.clear();
+    batch.colours.clear();
+    batch.normals.clear();
+    batch.textureCoords.clear();
+    batch.faceVertices.clear();
+    batch.faceColours.clear();
+    batch.faceNormals.clear();
+    batch.faceTexCoords.clear();
+
+    while (batch.faceTexCoords.size() < maxFaces * 3)
+        { // until the batch is full
+        const char *line = &text[0] + textBegin;
+        const char *newline = (const char *) memchr(line, '\n', textEnd - textBegin);
+
+        if (newline == NULL)
+            { // no whole line left
+            if (endOfFile)
+                { // last line
+                // the file may not end with a newline
+                if ((textBegin < textEnd) && !ParseLine(line, &text[0] + textEnd, batch))
+                    return false;
+                textBegin = textEnd;
+                break;
+                } // last line
+
+            // move the partial line to the front, making room if it fills the buffer
+            size_t partial = textEnd - textBegin;
+            memmove(&text[0], line, partial);
+            textBegin = 0;
+            textEnd = partial;
+            if (textEnd == text.size())
+                text.resize(text.size() * 2);
+
+            size_t bytes = fread(&text[textEnd], 1, text.size() - textEnd, file);
+            textEnd += bytes;
+            if (bytes == 0)
+                { // nothing more
+                if (ferror(file))
+                    { // read error
+                    std::cout << "Read error after " << faceCount << " faces" << std::endl;
+                    return false;
+                    } // read error
+                endOfFile = true;
+                } // nothing more
+            continue;
+            } // no whole line left
+
+        if (!ParseLine(line, newline, batch))
+            return false;
+        textBegin = newline + 1 - &text[0];
+        } // until the batch is full
+
+    return true;
+    } // NextBatch()
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ObjectParser.h
+//  ------------------------
+//
+//  Parses the text of an OBJ file held in memory (for
+//  instance a mapped file) into an AttributedObject.
+//
+//  The text is scanned in place: a first pass counts
+//  the lines of each kind so that every array can be
+//  sized once, and a second pass parses the numbers
+//  with hand-written routines instead of iostreams,
+//  which are locale-aware and slow.
+//
+//  Large files are cut into chunks at line boundaries
+//  and both passes run on the chunks in parallel.  The
+//  counts from the first pass are prefix-summed, so in
+//  the second each chunk writes straight into its own
+//  part of the arrays, and knows how many vertices &c.
+//  precede it for resolving negative (relative) face
+//  indices.
+//
+//  Text that arrives through a file or pipe is cut into
+//  pieces as it is read, and each piece is counted and
+//  parsed into arrays of its own while the next is read.
+//
+///////////////////////////////////////////////////
+
+// include guard for ObjectParser
+#ifndef _OBJECT_PARSER_H
+#define _OBJECT_PARSER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "AttributedObject.h"
+
+// parses the OBJ text in [begin, end) into the object's vertex & face arrays
+// using the given number of threads (0 for one per core)
+// returns false (after printing the offending line) if a face is malformed
+bool ParseObject(const char *begin, const char *end, AttributedObject &object, int threads = 0);
+
+// reads OBJ text from a file or pipe (say a decompressing one), parsing each
+// piece on a thread of its own as soon as it has been read, so that reading
+// overlaps with parsing; the pieces are gathered into the object at the end
+// returns false (after printing the offending line) if a face is malformed,
+// or if the input cannot be read
+bool ParseObjectFile(FILE *file, AttributedObject &object, int threads = 0);
+
+// reads OBJ text from a file or pipe a block at a time, and hands the faces
+// back in batches, keeping only the colours, normals and texture coordinates
+// seen so far rather than the whole mesh.  Faces may only refer to attributes
+// defined before them, as they are in every file we write (and most others)
+class ObjectStreamParser
+    { // class ObjectStreamParser
+    public:
+    // the number of faces handed back so far
+    size_t faceCount;
+
+    // constructor reads from an open file, which the caller closes
+    ObjectStreamParser(FILE *newFile);
+
+    // fills batch with up to maxFaces faces, each corner with attributes of its own
+    // (the batch has no vertex positions, which baking does not need)
+    // returns false if the input is malformed or unreadable
+    // the batch comes back empty once the input is used up
+    bool NextBatch(size_t maxFaces, AttributedObject &batch);
+
+    private:
+    // the input
+    FILE *file;
+    bool endOfFile;
+
+    // text read but not yet parsed is text[textBegin .. textEnd - 1]
+    std::vector<char> text;
+    size_t textBegin, textEnd;
+
+    // the attribute pools, and the number of positions (which are counted, not kept)
+    std::vector<Cartesian3> colours, normals, textureCoords;
+    size_t vertexCount;
+
+    // parses one line, adding any face to the batch; returns false if it is malformed
+    bool ParseLine(const char *line, const char *lineEnd, AttributedObject &batch);
+    }; // class ObjectStreamParser
+
+// end of include guard for ObjectParser
+#endif
@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ObjectWriter.cpp
+//  ------------------------
+//
+//  Writes an AttributedObject as OBJ text.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "ObjectWriter.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// local includes
+#include "WorkStealing.h"
+
+// the number of lines formatted into each buffer
+#define WRITE_CHUNK_LINES 4096
+
+// room for the longest line: "vc " and three floats of up to 45 characters
+// (the largest float in %.4f), or "f" and three corners of four 10-digit IDs
+#define WRITE_MAXIMUM_LINE 160
+
+// the number of chunks per thread formatted before they are written out
+#define WRITE_CHUNKS_PER_THREAD 2
+
+// writes an unsigned integer, returns the end of what was written
+static inline char *FormatUnsigned(char *out, uint64_t value)
+    { // FormatUnsigned()
+    char digits[20];
+    int count = 0;
+    do
+        { // per digit
+        digits[count++] = (char) ('0' + value % 10);
+        value /= 10;
+        } // per digit
+    while (value != 0);
+    while (count > 0)
+        *out++ = digits[--count];
+    return out;
+    } // FormatUnsigned()
+
+// writes a float with four decimals, as printf("%.4f") does, returns the end of what was written
+static inline char *FormatFixed4(char *out, float value)
+    { // FormatFixed4()
+    // a float has 24 significant bits, so value * 10^4 (14 bits) is exact in a double,
+    // and rounding it to nearest-even gives the same digits printf would
+    double scaled = (double) value * 10000.0;
+    if (!(std::fabs(scaled) < 9.0e18))
+        { // huge, infinite or NaN
+        return out + snprintf(out, WRITE_MAXIMUM_LINE, "%.4f", value);
+        } // huge, infinite or NaN
+
+    // printf keeps the sign of negative values that round to zero
+    if (std::signbit(value))
+        *out++ = '-';
+    uint64_t fixed = (uint64_t) std::llrint(std::fabs(scaled));
+
+    out = FormatUnsigned(out, fixed / 10000);
+    *out++ = '.';
+    unsigned int fraction = (unsigned int) (fixed % 10000);
+    out[0] = (char) ('0' + fraction / 1000);
+    out[1] = (char) ('0' + fraction / 100 % 10);
+    out[2] = (char) ('0' + fraction / 10 % 10);
+    out[3] = (char) ('0' + fraction % 10);
+    return out + 4;
+    } // FormatFixed4()
+
+// the sections of the file that are lists of lines
+enum WriteSection
+    { // enum WriteSection
+    WRITE_VERTICES,
+    WRITE_COLOURS,
+    WRITE_NORMALS,
+    WRITE_TEX_COORDS,
+    WRITE_FACES
+    }; // enum WriteSection
+
+// formats lines [first, last) of a section, returns the end of what was written
+static char *FormatLines(const AttributedObject &object, WriteSection section, size_t first, size_t last, char *out)
+    { // FormatLines()
+    if (section == WRITE_FACES)
+        { // faces
+        for (size_t face = first; face < last; face++)
+            { // per face
+            *out++ = 'f';
+            for (size_t corner = face * 3; corner < face * 3 + 3; corner++)
+                { // per vertex
+                *out++ = ' ';
+                out = FormatUnsigned(out, (uint64_t) object.faceVertices[corner] + 1);
+                *out++ = '/';
+                out = FormatUnsigned(out, (uint64_t) object.faceColours[corner] + 1);
+                *out++ = '/';
+                out = FormatUnsigned(out, (uint64_t) object.faceTexCoords[corner] + 1);
+                *out++ = '/';
+                out = FormatUnsigned(out, (uint64_t) object.faceNormals[corner] + 1);
+                } // per vertex
+            *out++ = '\n';
+            } // per face
+        return out;
+        } // faces
+
+    static const char *keywords[4] = { "v  ", "vc ", "vn ", "vt " };
+    const std::vector<Cartesian3> *arrays[4] = { &object.vertices, &object.colours, &object.normals, &object.textureCoords };
+    const std::vector<Cartesian3> &array = *arrays[section];
+    for (size_t line = first; line < last; line++)
+        { // per line
+        memcpy(out, keywords[section], 3);
+        out += 3;
+        out = FormatFixed4(out, array[line].x);
+        *out++ = ' ';
+        out = FormatFixed4(out, array[line].y);
+        *out++ = ' ';
+        out = FormatFixed4(out, array[line].z);
+        *out++ = '\n';
+        } // per line
+    return out;
+    } // FormatLines()
+
+// writes the object to the stream, formatting on the given number of threads (0 for one per core)
+// returns false if the stream failed
+bool WriteObject(const AttributedObject &object, std::ostream &geometryStream, int threads)
+    { // WriteObject()
+    if (threads <= 0)
+        threads = DefaultThreadCount();
+
+    // the buffers are allocated once and reused for every round of chunks
+    size_t nBuffers = (size_t) threads * WRITE_CHUNKS_PER_THREAD;
+    std::vector<std::vector<char> > buffers(nBuffers, std::vector<char>(WRITE_CHUNK_LINES * WRITE_MAXIMUM_LINE));
+    std::vector<size_t> used(nBuffers);
+
+    // the section headers
+    static const char *headers[4] = { " vertices", " vertex colours", " vertex normals", " vertex tex coords" };
+    size_t counts[WRITE_FACES + 1] = { object.vertices.size(), object.colours.size(), object.normals.size(),
+                                       object.textureCoords.size(), object.faceVertices.size() / 3 };
+
+    geometryStream << "# " << counts[WRITE_FACES] << " triangles\n\n";
+    for (int section = WRITE_VERTICES; section <= WRITE_FACES; section++)
+        { // per section
+        if (section != WRITE_FACES)
+            geometryStream << "# " << counts[section] << headers[section] << "\n";
+
+        size_t nChunks = (counts[section] + WRITE_CHUNK_LINES - 1) / WRITE_CHUNK_LINES;
+        for (size_t round = 0; round < nChunks; round += nBuffers)
+            { // per round
+            // format a round of chunks side by side
+            int roundChunks = (int) std::min(nBuffers, nChunks - round);
+            RunWorkStealing(roundChunks, threads, [&](int, int chunk)
+                { // per chunk
+                size_t first = (round + chunk) * WRITE_CHUNK_LINES;
+                size_t last = std::min(first + WRITE_CHUNK_LINES, counts[section]);
+                char *start = &buffers[chunk][0];
+                used[chunk] = FormatLines(object, (WriteSection) section, first, last, start) - start;
+                }); // per chunk
+
+            // then write them out in order
+            for (int chunk = 0; chunk < roundChunks; chunk++)
+                geometryStream.write(&buffers[chunk][0], used[chunk]);
+            } // per round
+        } // per section
+
+    geometryStream.flush();
+    return geometryStream.good();
+    } // WriteObject()
@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ObjectWriter.h
+//  ------------------------
+//
+//  Writes an AttributedObject as OBJ text.
+//
+//  Lines are formatted by hand into large buffers, a
+//  chunk of lines at a time, and each buffer goes to the
+//  stream in one write, so nothing is flushed per line.
+//  With more than one thread, several chunks are
+//  formatted at once and written out in order.
+//
+//  Coordinates are written with four decimals, exactly
+//  as printf("%.4f") would write them.
+//
+///////////////////////////////////////////////////
+
+// include guard for ObjectWriter
+#ifndef _OBJECT_WRITER_H
+#define _OBJECT_WRITER_H
+
+#include <iostream>
+
+#include "AttributedObject.h"
+
+// writes the object to the stream, formatting on the given number of threads (0 for one per core)
+// returns false if the stream failed
+bool WriteObject(const AttributedObject &object, std::ostream &geometryStream, int threads = 1);
+
+// end of include guard for ObjectWriter
+#endif
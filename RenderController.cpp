@@ -34,7 +34,8 @@ RenderController::RenderController
     attributedObject(newAttributedObject),
     renderParameters(newRenderParameters),
     renderWindow    (newRenderWindow),
-    dragButton      (Qt::NoButton)
+    dragButton      (Qt::NoButton),
+    interfaceChanged(false)
     { // RenderController::RenderController()
     
     // connect up signals to slots
@@ -63,18 +64,50 @@ RenderController::RenderController
     QObject::connect(   renderWindow->yTranslateSlider,             SIGNAL(valueChanged(int)),
                         this,                                       SLOT(yTranslateChanged(int)));
 
+    // signal for baked maps check box
+    QObject::connect(   renderWindow->bakedMapsBox,                 SIGNAL(stateChanged(int)),
+                        this,                                       SLOT(bakedMapsChanged(int)));
+
+    // signal for the render widget finding out whether the baked maps can be shown
+    QObject::connect(   renderWindow->renderWidget,                 SIGNAL(BakedMapsAvailable(bool)),
+                        this,                                       SLOT(bakedMapsAvailable(bool)));
+
+    // signal for the render widget finishing a frame
+    QObject::connect(   renderWindow->renderWidget,                 SIGNAL(frameSwapped()),
+                        this,                                       SLOT(renderFrameSwapped()));
+
     // copy the rotation matrix from the widgets to the model
     renderParameters->rotationMatrix = renderWindow->modelRotator->RotationMatrix();
     } // RenderController::RenderController()
 
+// called after every change to the model: the render widget's update
+// requests are merged into one repaint per frame by Qt, and the controls
+// are reset once that frame is out, however many changes came before it
+void RenderController::ModelChanged()
+    { // RenderController::ModelChanged()
+    interfaceChanged = true;
+    renderWindow->renderWidget->update();
+    } // RenderController::ModelChanged()
+
+// slot for the render widget finishing a frame
+void RenderController::renderFrameSwapped()
+    { // RenderController::renderFrameSwapped()
+    if (!interfaceChanged)
+        return;
+    interfaceChanged = false;
+
+    // reset the interface
+    renderWindow->ResetInterface();
+    } // RenderController::renderFrameSwapped()
+
 // slot for responding to arcball rotation for object
 void RenderController::objectRotationChanged()
     { // RenderController::objectRotationChanged()
     // copy the rotation matrix from the widget to the model
     renderParameters->rotationMatrix = renderWindow->modelRotator->RotationMatrix();
     
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::objectRotationChanged()
 
 // slot for responding to zoom slider
@@ -92,8 +125,8 @@ void RenderController::zoomChanged(int value)
     // and reset the value  
     renderParameters->zoomScale = newZoomScale;
     
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::zoomChanged()
 
 // slot for responding to x translate sliders
@@ -108,8 +141,8 @@ void RenderController::xTranslateChanged(int value)
     else if (renderParameters->xTranslate > TRANSLATE_MAX)
         renderParameters->xTranslate = TRANSLATE_MAX;
     
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::xTranslateChanged()
 
 // slot for responding to y translate slider
@@ -124,10 +157,33 @@ void RenderController::yTranslateChanged(int value)
     else if (renderParameters->yTranslate > TRANSLATE_MAX)
         renderParameters->yTranslate = TRANSLATE_MAX;
     
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::yTranslateChanged()
     
+// slot for responding to the baked maps check box
+void RenderController::bakedMapsChanged(int state)
+    { // RenderController::bakedMapsChanged()
+    // switch between vertex colours & the baked maps
+    renderParameters->useBakedMaps = (state == Qt::Checked);
+
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
+    } // RenderController::bakedMapsChanged()
+
+// slot for the render widget finding out whether the baked maps can be shown
+void RenderController::bakedMapsAvailable(bool available)
+    { // RenderController::bakedMapsAvailable()
+    // the check box is only offered if ticking it would do something
+    renderWindow->bakedMapsBox->setEnabled(available);
+    if (available || !renderParameters->useBakedMaps)
+        return;
+
+    // fall back on the vertex colours, and bring the controls into line
+    renderParameters->useBakedMaps = false;
+    ModelChanged();
+    } // RenderController::bakedMapsAvailable()
+
 // slots for responding to arcball manipulations
 // these are general purpose signals which pass the mouse moves to the controller
 // after scaling to the notional unit sphere
@@ -142,11 +198,12 @@ void RenderController::BeginScaledDrag(int whichButton, float x, float y)
         // left button drags the model
         case Qt::LeftButton:
             renderWindow->modelRotator->BeginDrag(x, y);
+            renderParameters->dragging = true;
             break;
         } // switch on the drag button
 
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::BeginScaledDrag()
     
 // note that Continue & End assume the button has already been set
@@ -161,8 +218,8 @@ void RenderController::ContinueScaledDrag(float x, float y)
             break;
         } // switch on the drag button
 
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::ContinueScaledDrag()
 
 void RenderController::EndScaledDrag(float x, float y)
@@ -173,13 +230,14 @@ void RenderController::EndScaledDrag(float x, float y)
         // left button drags the model
         case Qt::LeftButton:
             renderWindow->modelRotator->EndDrag(x, y);
+            renderParameters->dragging = false;
             break;
         } // switch on the drag button
 
     // and reset the drag button
     dragButton = Qt::NoButton;
 
-    // reset the interface
-    renderWindow->ResetInterface();
+    // redraw, and bring the controls into line after the frame
+    ModelChanged();
     } // RenderController::EndScaledDrag()
 
@@ -46,6 +46,12 @@ class RenderController : public QObject
     
     // local variable for tracking mouse-drag in shared widgets
     int dragButton;
+
+    // whether the model has changed since the controls were last reset
+    bool interfaceChanged;
+
+    // called after every change to the model
+    void ModelChanged();
     
     public:
     // constructor
@@ -67,6 +73,15 @@ class RenderController : public QObject
     void zoomChanged(int value);
     void xTranslateChanged(int value);
     void yTranslateChanged(int value);
+
+    // slot for responding to the baked maps check box
+    void bakedMapsChanged(int state);
+
+    // slot for the render widget finding out whether the baked maps can be shown
+    void bakedMapsAvailable(bool available);
+
+    // slot for the render widget finishing a frame
+    void renderFrameSwapped();
     
     // slots for responding to arcball manipulations
     // these are general purpose signals which pass the mouse moves to the controller
@@ -36,13 +36,23 @@ class RenderParameters
     float zoomScale;
     
     Matrix4 rotationMatrix;
+
+    // whether to show the baked texture & normal maps, lit per pixel,
+    // rather than the vertex colours
+    bool useBakedMaps;
+
+    // whether the object is being dragged round, so that a coarser
+    // level of detail will do
+    bool dragging;
     
     // constructor
     RenderParameters()
         :
         xTranslate(0.0), 
         yTranslate(0.0),
-        zoomScale(1.0)
+        zoomScale(1.0),
+        useBakedMaps(false),
+        dragging(false)
         { // constructor
 
         // because we are paranoid, we will initialise the matrices to the identity
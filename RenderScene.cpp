@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  RenderScene.cpp
+//  ------------------------
+//
+//  Draws the viewer's scene into whatever OpenGL
+//  context is current.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "RenderScene.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+
+// milliseconds between two times
+static float Milliseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    { // Milliseconds()
+    return std::chrono::duration<float, std::milli>(to - from).count();
+    } // Milliseconds()
+
+// constructor stores the pointers
+RenderScene::RenderScene(AttributedObject *newAttributedObject, RenderParameters *newRenderParameters,
+                         const TextureBaker *newTextureBaker)
+    : attributedObject(newAttributedObject),
+    renderParameters(newRenderParameters),
+    textureBaker(newTextureBaker),
+    width(1), height(1),
+    createdLevels(0),
+    meshletLevels(0),
+    firstFrame(std::chrono::steady_clock::now()),
+    nextTimerQuery(0)
+    { // RenderScene()
+    for (int query = 0; query < FRAME_TIMER_QUERIES; query++)
+        timerQueryFrames[query] = -1;
+    } // RenderScene()
+
+// sets up lighting & depth-buffering and puts the object on the GPU
+void RenderScene::Initialize()
+    { // Initialize()
+    // set lighting parameters (may be reset later)
+    glShadeModel(GL_SMOOTH);
+    glEnable(GL_LIGHT0);
+    glEnable(GL_LIGHTING);
+    glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_FALSE);
+
+    // background is yellowish-grey
+    glClearColor(0.8, 0.8, 0.6, 1.0);
+
+    // enable depth-buffering
+    glEnable(GL_DEPTH_TEST);
+
+    // put the object on the GPU
+    meshLevels.Build(*attributedObject);
+    meshBuffers[0].Create(meshLevels.Level(0));
+    createdLevels = 1;
+
+    // and its maps, if both were baked
+    if (textureBaker != NULL)
+        bakedMapShader.Create(textureBaker->Map(BAKE_CHANNEL_TEXTURE), textureBaker->Map(BAKE_CHANNEL_NORMAL));
+
+    // GPU timers need GL 3.3 or ARB_timer_query; without them only CPU times are kept
+    for (int query = 0; query < FRAME_TIMER_QUERIES; query++)
+        timerQueries[query].create();
+    } // Initialize()
+
+// resets the viewport & projection for a new size
+void RenderScene::Resize(int newWidth, int newHeight)
+    { // Resize()
+    width = newWidth;
+    height = newHeight;
+
+    // reset the viewport
+    glViewport(0, 0, width, height);
+
+    // set projection matrix to be glOrtho based on zoom & window size
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+
+    // compute the aspect ratio of the widget
+    float aspectRatio = (float) width / (float) height;
+
+    // we want to capture a sphere of radius 1.0 without distortion
+    // so we set the ortho projection based on whether the window is portrait (> 1.0) or landscape
+    // portrait ratio is wider, so make bottom & top -1.0 & 1.0
+    if (aspectRatio > 1.0)
+        glOrtho(-aspectRatio, aspectRatio, -1.0, 1.0, -1.0, 1.0);
+    // otherwise, make left & right -1.0 & 1.0
+    else
+        glOrtho(-1.0, 1.0, -1.0/aspectRatio, 1.0/aspectRatio, -1.0, 1.0);
+    } // Resize()
+
+// draws one frame, recording its timings
+bool RenderScene::Paint(const std::chrono::steady_clock::time_point *inputTime)
+    { // Paint()
+    std::chrono::steady_clock::time_point paintStart = std::chrono::steady_clock::now();
+    CollectTimerQueries();
+
+    // a painter drawn over the scene turns depth-buffering off when it ends
+    glEnable(GL_DEPTH_TEST);
+
+    // clear the buffer
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // set model view matrix based on stored translation, rotation &c.
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    // start with lighting turned off
+    glDisable(GL_LIGHTING);
+
+    // translate by the visual translation
+    glTranslatef(renderParameters->xTranslate, renderParameters->yTranslate, 0.0f);
+
+    // apply rotation matrix from arcball
+    glMultMatrixf(renderParameters->rotationMatrix.columnMajor().coordinates);
+
+    // give buffers to any levels finished since the last frame (they are
+    // only needed once the view changes, which brings another frame anyway)
+    for (; createdLevels < meshLevels.ReadyLevels(); createdLevels++)
+        meshBuffers[createdLevels].Create(meshLevels.Level(createdLevels));
+    for (; meshletLevels < std::min(createdLevels, meshLevels.ReadyMeshlets()); meshletLevels++)
+        meshBuffers[meshletLevels].SetMeshlets(&meshLevels.Meshlets(meshletLevels));
+
+    // while a level is still uploading, each frame adds a slice
+    // (finest level first)
+    bool uploading = false;
+    for (int level = 0; (level < createdLevels) && !uploading; level++)
+        uploading = !meshBuffers[level].Upload();
+
+    // pick a level for the object's size on screen, coarser while it is
+    // dragged, falling back to a finer one if the level is still uploading
+    int level = meshLevels.ChooseLevel(createdLevels, width, height, renderParameters->zoomScale,
+                                       renderParameters->dragging);
+    while ((level > 0) && !meshBuffers[level].IsUploaded())
+        level--;
+
+    // draw the object from its buffers, through its maps if asked,
+    // passing in the render parameters for reference
+    // (on the GPU timer too, if a query is free)
+    QOpenGLTimerQuery *timerQuery = NULL;
+    if (timerQueries[nextTimerQuery].isCreated() && (timerQueryFrames[nextTimerQuery] < 0))
+        timerQuery = &timerQueries[nextTimerQuery];
+    std::chrono::steady_clock::time_point drawStart = std::chrono::steady_clock::now();
+    if (timerQuery != NULL)
+        timerQuery->begin();
+    bool useBakedMaps = renderParameters->useBakedMaps && bakedMapShader.IsReady();
+    if (useBakedMaps)
+        bakedMapShader.Bind();
+    size_t triangles = meshBuffers[level].Render(*attributedObject, renderParameters);
+    if (useBakedMaps)
+        bakedMapShader.Release();
+    if (timerQuery != NULL)
+        timerQuery->end();
+    std::chrono::steady_clock::time_point drawEnd = std::chrono::steady_clock::now();
+
+    // record the frame, leaving its GPU time to be filled in later
+    FrameSample sample;
+    sample.time = std::chrono::duration<double>(paintStart - firstFrame).count();
+    sample.paintMilliseconds = Milliseconds(paintStart, drawEnd);
+    sample.drawMilliseconds = Milliseconds(drawStart, drawEnd);
+    sample.gpuMilliseconds = -1.0f;
+    sample.latencyMilliseconds = (inputTime != NULL) ? Milliseconds(*inputTime, drawEnd) : -1.0f;
+    sample.triangles = triangles;
+    sample.level = level;
+    unsigned long frame = frameStats.Record(sample);
+    if (timerQuery != NULL)
+        { // query in flight
+        timerQueryFrames[nextTimerQuery] = (long) frame;
+        nextTimerQuery = (nextTimerQuery + 1) % FRAME_TIMER_QUERIES;
+        } // query in flight
+
+    return !uploading;
+    } // Paint()
+
+// waits until every level of detail has been simplified
+void RenderScene::WaitForLevels()
+    { // WaitForLevels()
+    meshLevels.Wait();
+    } // WaitForLevels()
+
+// frees everything on the GPU
+void RenderScene::Destroy()
+    { // Destroy()
+    for (int level = 0; level < createdLevels; level++)
+        meshBuffers[level].Destroy();
+    createdLevels = meshletLevels = 0;
+    bakedMapShader.Destroy();
+    for (int query = 0; query < FRAME_TIMER_QUERIES; query++)
+        { // per query
+        timerQueries[query].destroy();
+        timerQueryFrames[query] = -1;
+        } // per query
+    } // Destroy()
+
+// records the results of any timer queries that have finished
+void RenderScene::CollectTimerQueries()
+    { // CollectTimerQueries()
+    for (int query = 0; query < FRAME_TIMER_QUERIES; query++)
+        if ((timerQueryFrames[query] >= 0) && timerQueries[query].isResultAvailable())
+            { // finished
+            frameStats.RecordGPUTime((unsigned long) timerQueryFrames[query], timerQueries[query].waitForResult() / 1.0e6f);
+            timerQueryFrames[query] = -1;
+            } // finished
+    } // CollectTimerQueries()
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  RenderScene.h
+//  ------------------------
+//
+//  Draws the viewer's scene into whatever OpenGL
+//  context is current: the render widget's, or an
+//  offscreen framebuffer for the viewer benchmark.
+//
+//  It owns everything the object needs on the GPU:
+//  the levels of detail & their buffers, the baked
+//  map shader, and the timer queries, and keeps the
+//  timings of the frames it draws.
+//
+///////////////////////////////////////////////////
+
+// include guard for RenderScene
+#ifndef _RENDER_SCENE_H
+#define _RENDER_SCENE_H
+
+#include <chrono>
+
+#include <QOpenGLTimerQuery>
+
+#include "AttributedObject.h"
+#include "BakedMapShader.h"
+#include "FrameStats.h"
+#include "MeshBuffers.h"
+#include "MeshLevels.h"
+#include "RenderParameters.h"
+#include "TextureBaker.h"
+
+// GPU timer queries in flight at once
+#define FRAME_TIMER_QUERIES 4
+
+class RenderScene
+    { // class RenderScene
+    public:
+    // constructor stores the pointers; the baker may be NULL if nothing was baked
+    RenderScene(AttributedObject *newAttributedObject, RenderParameters *newRenderParameters,
+                const TextureBaker *newTextureBaker);
+
+    // sets up lighting & depth-buffering and puts the object on the GPU
+    // (large objects carry on uploading in Paint, and the coarser levels
+    // follow as they are simplified); the context must be current
+    void Initialize();
+
+    // resets the viewport & projection for a new size
+    void Resize(int newWidth, int newHeight);
+
+    // draws one frame, recording its timings with the time of the input
+    // that asked for it (or NULL if there was none)
+    // returns false if the object is still uploading and needs another frame
+    bool Paint(const std::chrono::steady_clock::time_point *inputTime);
+
+    // waits until every level of detail has been simplified
+    void WaitForLevels();
+
+    // whether the baked maps can be drawn: both were baked, fitted on the
+    // GPU and the shader compiled (known once Initialize() has run)
+    bool BakedMapsAvailable() const
+        { return bakedMapShader.IsReady(); }
+
+    // frees everything on the GPU; the context must be current
+    void Destroy();
+
+    // timings of recent frames
+    const FrameStats &Stats() const
+        { return frameStats; }
+
+    // whether GPU times are being measured
+    bool HasGPUTimer() const
+        { return timerQueries[0].isCreated(); }
+
+    private:
+    // the geometric object, the render parameters, and its maps
+    AttributedObject *attributedObject;
+    RenderParameters *renderParameters;
+    const TextureBaker *textureBaker;
+
+    // the size of the viewport
+    int width, height;
+
+    // the object at several levels of detail
+    MeshLevels meshLevels;
+
+    // and each level as it is kept on the GPU
+    MeshBuffers meshBuffers[LOD_MAXIMUM_LEVELS];
+
+    // how many levels have buffers so far, and how many of those cull by meshlets
+    int createdLevels, meshletLevels;
+
+    // and the shader that shows it through its baked maps
+    BakedMapShader bakedMapShader;
+
+    // timings of recent frames, and when the first frame started
+    FrameStats frameStats;
+    std::chrono::steady_clock::time_point firstFrame;
+
+    // GPU timer queries, used in turn since their results arrive late,
+    // and the frame each is timing (or -1 if it is free)
+    QOpenGLTimerQuery timerQueries[FRAME_TIMER_QUERIES];
+    long timerQueryFrames[FRAME_TIMER_QUERIES];
+    int nextTimerQuery;
+
+    // records the results of any timer queries that have finished
+    void CollectTimerQueries();
+    }; // class RenderScene
+
+// end of include guard for RenderScene
+#endif
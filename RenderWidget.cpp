@@ -32,6 +32,10 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include <math.h>
+#include <algorithm>
+#include <iostream>
+
+#include <QPainter>
 
 // include the header file
 #include "RenderWidget.h"
@@ -43,6 +47,8 @@ RenderWidget::RenderWidget
         AttributedObject 	*newAttributedObject,
         // the render parameters to use
         RenderParameters    *newRenderParameters,
+        // the baker holding the object's maps
+        const TextureBaker  *newTextureBaker,
         // parent widget in visual hierarchy
         QWidget             *parent
         )
@@ -53,87 +59,115 @@ RenderWidget::RenderWidget
     QOpenGLWidget(parent),
     // then store the pointers that were passed in
     attributedObject(newAttributedObject),
-    renderParameters(newRenderParameters)
+    renderParameters(newRenderParameters),
+    renderScene(newAttributedObject, newRenderParameters, newTextureBaker),
+    showFrameStats(false),
+    inputPending(false)
     { // constructor
-    // leaves nothing to put into the constructor body
+    // take keyboard focus when clicked, for the frame-time keys
+    setFocusPolicy(Qt::StrongFocus);
     } // constructor    
 
 // destructor
 RenderWidget::~RenderWidget()
     { // destructor
-    // empty (for now)
     // all of our pointers are to data owned by another class
     // so we have no responsibility for destruction
-    // and OpenGL cleanup is taken care of by Qt
+    // but the buffers must be freed in our own context
+    makeCurrent();
+    renderScene.Destroy();
+    doneCurrent();
     } // destructor                                                                 
 
 // called when OpenGL context is set up
 void RenderWidget::initializeGL()
     { // RenderWidget::initializeGL()
-    // set lighting parameters (may be reset later)
-    glShadeModel(GL_SMOOTH);
-    glEnable(GL_LIGHT0);
-    glEnable(GL_LIGHTING);
-    glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_FALSE);
-    
-    // background is yellowish-grey
-    glClearColor(0.8, 0.8, 0.6, 1.0);
+    // the scene sets up lighting &c. and puts the object on the GPU
+    renderScene.Initialize();
 
-    // enable depth-buffering
-	glEnable(GL_DEPTH_TEST);
+    // only now is it known whether the maps fitted on the GPU and the shader compiled
+    emit BakedMapsAvailable(renderScene.BakedMapsAvailable());
     } // RenderWidget::initializeGL()
 
 // called every time the widget is resized
 void RenderWidget::resizeGL(int w, int h)
     { // RenderWidget::resizeGL()
-    // reset the viewport
-    glViewport(0, 0, w, h);
-    
-    // set projection matrix to be glOrtho based on zoom & window size
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    
-    // compute the aspect ratio of the widget
-    float aspectRatio = (float) w / (float) h;
-    
-    // we want to capture a sphere of radius 1.0 without distortion
-    // so we set the ortho projection based on whether the window is portrait (> 1.0) or landscape
-    // portrait ratio is wider, so make bottom & top -1.0 & 1.0
-    if (aspectRatio > 1.0)
-        glOrtho(-aspectRatio, aspectRatio, -1.0, 1.0, -1.0, 1.0);
-    // otherwise, make left & right -1.0 & 1.0
-    else
-        glOrtho(-1.0, 1.0, -1.0/aspectRatio, 1.0/aspectRatio, -1.0, 1.0);
-
+    // reset the viewport & projection
+    renderScene.Resize(w, h);
     } // RenderWidget::resizeGL()
     
 // called every time the widget needs painting
 void RenderWidget::paintGL()
     { // RenderWidget::paintGL()
-    // clear the buffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // draw the scene; while a large object is still uploading, each
+    // frame adds a slice and asks for another frame
+    if (!renderScene.Paint(inputPending ? &inputTime : NULL))
+        update();
+    inputPending = false;
 
-    // set model view matrix based on stored translation, rotation &c.
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-        
-    // start with lighting turned off
-    glDisable(GL_LIGHTING);
+    // the overlay is not counted in the frame's own time
+    if (showFrameStats)
+        DrawFrameStats();
+    } // RenderWidget::paintGL()
 
-	// translate by the visual translation
-	glTranslatef(renderParameters->xTranslate, renderParameters->yTranslate, 0.0f);
+// draws the frame-time histogram & counters over the scene
+void RenderWidget::DrawFrameStats()
+    { // RenderWidget::DrawFrameStats()
+    const FrameStats &frameStats = renderScene.Stats();
+    std::vector<int> bins;
+    frameStats.Histogram(bins);
+    int tallest = std::max(1, *std::max_element(bins.begin(), bins.end()));
+    const FrameSample &newest = frameStats.Sample(frameStats.Count() - 1);
 
-	// apply rotation matrix from arcball
-	glMultMatrixf(renderParameters->rotationMatrix.columnMajor().coordinates);
+    // a translucent panel in the top left corner
+    const int barWidth = 8, barsHeight = 60, margin = 8, lineHeight = 14;
+    int panelWidth = FRAME_STATS_BINS * barWidth + 2 * margin;
+    int panelHeight = barsHeight + 5 * lineHeight + 3 * margin;
+    QPainter painter(this);
+    painter.fillRect(0, 0, panelWidth, panelHeight, QColor(0, 0, 0, 160));
 
-    // tell the object to draw itself, 
-    // passing in the render parameters for reference
-    attributedObject->Render(renderParameters);
-    } // RenderWidget::paintGL()
+    // the histogram of paintGL times, FRAME_STATS_BIN_MILLISECONDS per bar
+    for (int bin = 0; bin < FRAME_STATS_BINS; bin++)
+        { // per bin
+        int height = bins[bin] * barsHeight / tallest;
+        QColor colour = (bin * FRAME_STATS_BIN_MILLISECONDS < 16.7f) ? QColor(80, 220, 80)
+                      : (bin * FRAME_STATS_BIN_MILLISECONDS < 33.3f) ? QColor(230, 200, 60) : QColor(230, 70, 60);
+        painter.fillRect(margin + bin * barWidth, margin + barsHeight - height, barWidth - 1, height, colour);
+        } // per bin
+
+    // and the counters below it
+    painter.setPen(Qt::white);
+    QFont font = painter.font();
+    font.setPixelSize(lineHeight - 2);
+    painter.setFont(font);
+    QString lines[5] =
+        { // lines
+        QString("paint %1 ms, p95 %2 ms").arg(frameStats.PaintPercentile(50.0f), 0, 'f', 1).arg(frameStats.PaintPercentile(95.0f), 0, 'f', 1),
+        QString("draw %1 ms CPU").arg(newest.drawMilliseconds, 0, 'f', 1),
+        (newest.gpuMilliseconds >= 0.0f) ? QString("draw %1 ms GPU").arg(newest.gpuMilliseconds, 0, 'f', 1) : QString("draw GPU pending"),
+        QString("%1 redraws/s").arg(frameStats.RedrawsPerSecond()),
+        QString("%1 triangles, level %2").arg((qulonglong) newest.triangles).arg(newest.level)
+        }; // lines
+    if (!renderScene.HasGPUTimer())
+        lines[2] = QString("no GPU timer");
+    for (int line = 0; line < 5; line++)
+        painter.drawText(margin, 2 * margin + barsHeight + (line + 1) * lineHeight, lines[line]);
+    } // RenderWidget::DrawFrameStats()
+
+// notes when input arrives, for the latency of the frame it causes
+void RenderWidget::NoteInput()
+    { // RenderWidget::NoteInput()
+    if (!inputPending)
+        { // first since the last frame
+        inputTime = std::chrono::steady_clock::now();
+        inputPending = true;
+        } // first since the last frame
+    } // RenderWidget::NoteInput()
     
 // mouse-handling
 void RenderWidget::mousePressEvent(QMouseEvent *event)
     { // RenderWidget::mousePressEvent()
+    NoteInput();
     // store the button for future reference
     int whichButton = event->button();
     // scale the event to the nominal unit sphere in the widget:
@@ -156,6 +190,7 @@ void RenderWidget::mousePressEvent(QMouseEvent *event)
     
 void RenderWidget::mouseMoveEvent(QMouseEvent *event)
     { // RenderWidget::mouseMoveEvent()
+    NoteInput();
     // scale the event to the nominal unit sphere in the widget:
     // find the minimum of height & width   
     float size = (width() > height()) ? height() : width();
@@ -169,6 +204,7 @@ void RenderWidget::mouseMoveEvent(QMouseEvent *event)
     
 void RenderWidget::mouseReleaseEvent(QMouseEvent *event)
     { // RenderWidget::mouseReleaseEvent()
+    NoteInput();
     // scale the event to the nominal unit sphere in the widget:
     // find the minimum of height & width   
     float size = (width() > height()) ? height() : width();
@@ -179,3 +215,24 @@ void RenderWidget::mouseReleaseEvent(QMouseEvent *event)
     // send signal to the controller for detailed processing
     emit EndScaledDrag(x,y);
     } // RenderWidget::mouseReleaseEvent()
+
+// key-handling: F shows or hides the frame times, C writes them out
+void RenderWidget::keyPressEvent(QKeyEvent *event)
+    { // RenderWidget::keyPressEvent()
+    switch (event->key())
+        { // switch on the key
+        case Qt::Key_F:
+            showFrameStats = !showFrameStats;
+            update();
+            break;
+        case Qt::Key_C:
+            if (renderScene.Stats().WriteCSV(FRAME_STATS_FILE))
+                std::cout << "Wrote " << renderScene.Stats().Count() << " frame times to " << FRAME_STATS_FILE << std::endl;
+            else
+                std::cout << "Could not write " << FRAME_STATS_FILE << std::endl;
+            break;
+        default:
+            QOpenGLWidget::keyPressEvent(event);
+            break;
+        } // switch on the key
+    } // RenderWidget::keyPressEvent()
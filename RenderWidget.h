@@ -38,10 +38,18 @@
 // include the relevant QT headers
 #include <QOpenGLWidget>
 #include <QMouseEvent>
+#include <QKeyEvent>
+
+#include <chrono>
 
 // and include all of our own headers that we need
 #include "AttributedObject.h"
 #include "RenderParameters.h"
+#include "RenderScene.h"
+#include "TextureBaker.h"
+
+// where C writes the frame times
+#define FRAME_STATS_FILE "output/frame_stats.csv"
 
 // class for a render widget with arcball linked to an external arcball widget
 class RenderWidget : public QOpenGLWidget                                       
@@ -54,6 +62,22 @@ class RenderWidget : public QOpenGLWidget
     // the render parameters to use
     RenderParameters *renderParameters;
 
+    // everything drawn, and what it needs on the GPU
+    RenderScene renderScene;
+
+    // whether to show the timings of recent frames over the scene
+    bool showFrameStats;
+
+    // when the input that asked for the next frame arrived, if any has
+    std::chrono::steady_clock::time_point inputTime;
+    bool inputPending;
+
+    // draws the frame-time histogram & counters over the scene
+    void DrawFrameStats();
+
+    // notes when input arrives, for the latency of the frame it causes
+    void NoteInput();
+
     public:
     // constructor
     RenderWidget
@@ -62,6 +86,8 @@ class RenderWidget : public QOpenGLWidget
        		AttributedObject	*newAttributedObject,
             // the render parameters to use
             RenderParameters    *newRenderParameters,
+            // the baker holding the object's maps
+            const TextureBaker  *newTextureBaker,
             // parent widget in visual hierarchy
             QWidget             *parent
             );
@@ -82,6 +108,9 @@ class RenderWidget : public QOpenGLWidget
     virtual void mouseMoveEvent(QMouseEvent *event);
     virtual void mouseReleaseEvent(QMouseEvent *event);
 
+    // key-handling: F shows or hides the frame times, C writes them out
+    virtual void keyPressEvent(QKeyEvent *event);
+
     // these signals are needed to support shared arcball control
     public:
     signals:
@@ -91,6 +120,9 @@ class RenderWidget : public QOpenGLWidget
     // note that Continue & End assume the button has already been set
     void ContinueScaledDrag(float x, float y);
     void EndScaledDrag(float x, float y);
+
+    // sent once the context is set up: whether the baked maps can be shown
+    void BakedMapsAvailable(bool available);
     }; // class RenderWidget
 
 #endif
@@ -32,6 +32,8 @@ RenderWindow::RenderWindow
         AttributedObject         *newAttributedObject, 
         // the model object storing render parameters
         RenderParameters        *newRenderParameters,
+        // the baker holding the object's maps
+        const TextureBaker      *newTextureBaker,
         // the title for the window (with default value)
         const char              *windowName
         )
@@ -51,7 +53,7 @@ RenderWindow::RenderWindow
     windowLayout = new QGridLayout(this);
     
     // create all of the widgets, starting with the custom render widgets
-    renderWidget                = new RenderWidget              (newAttributedObject,     		newRenderParameters,        this);
+    renderWidget                = new RenderWidget              (newAttributedObject,     		newRenderParameters,        newTextureBaker,    this);
 
     // construct custom arcball Widgets
     modelRotator                = new ArcBallWidget             (                       this);
@@ -67,6 +69,10 @@ RenderWindow::RenderWindow
     modelRotatorLabel           = new QLabel                    ("Model",               this);
     yTranslateLabel             = new QLabel                    ("Y",                   this);
     zoomLabel                   = new QLabel                    ("Zm",                  this);
+
+    // display mode, only offered once the render widget has put both maps on the GPU
+    bakedMapsBox                = new QCheckBox                 ("Baked maps",          this);
+    bakedMapsBox                ->setEnabled(false);
     
     // add all of the widgets to the grid               Row         Column      Row Span    Column Span
     
@@ -80,6 +86,7 @@ RenderWindow::RenderWindow
 
     windowLayout->addWidget(modelRotator,               0,          3,          1,          1           );
     windowLayout->addWidget(modelRotatorLabel,          1,          3,          1,          1           );
+    windowLayout->addWidget(bakedMapsBox,               2,          3,          1,          1           );
 
     // Translate Slider Row
     windowLayout->addWidget(xTranslateSlider,           nStacked,   1,          1,          1           );
@@ -93,9 +100,16 @@ RenderWindow::RenderWindow
 
 // routine to reset interface
 // sets every visual control to match the model
-// gets called by the controller after each change in the model
+// gets called by the controller once per frame after changes in the model
+// (the controller asks the render widget to redraw itself)
 void RenderWindow::ResetInterface()
     { // RenderWindow::ResetInterface()
+    // setting the controls must not signal the controller back, or each
+    // change would come round again, rounded to the controls' steps
+    const QSignalBlocker xTranslateBlocker(xTranslateSlider);
+    const QSignalBlocker yTranslateBlocker(yTranslateSlider);
+    const QSignalBlocker zoomBlocker(zoomSlider);
+    const QSignalBlocker bakedMapsBlocker(bakedMapsBox);
    
     // set sliders
     // x & y translate are scaled to notional unit sphere in render widgets
@@ -113,8 +127,10 @@ void RenderWindow::ResetInterface()
     zoomSlider              ->setMaximum        ((int) (ZOOM_SCALE_LOG_MAX                          * PARAMETER_SCALING));
     zoomSlider              ->setValue          ((int) (log10(renderParameters -> zoomScale)        * PARAMETER_SCALING));
 
+    // display mode
+    bakedMapsBox            ->setChecked        (renderParameters -> useBakedMaps);
+
     // now flag them all for update 
-    renderWidget            ->update();
     modelRotator            ->update();
     xTranslateSlider        ->update();
     yTranslateSlider        ->update();
@@ -63,6 +63,9 @@ class RenderWindow : public QWidget
     QLabel                      *yTranslateLabel;
     QLabel                      *zoomLabel;
 
+    // switches between vertex colours & the baked maps
+    QCheckBox                   *bakedMapsBox;
+
     public:
     // constructor
     RenderWindow
@@ -71,6 +74,8 @@ class RenderWindow : public QWidget
         AttributedObject         		*newAttributedObject, 
         // the model object storing render parameters
         RenderParameters        *newRenderParameters,
+        // the baker holding the object's maps
+        const TextureBaker      *newTextureBaker,
         // the title for the window (with default value)
         const char              *windowName = "Object Renderer"
         );  
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  StreamingBake.cpp
+//  ------------------------
+//
+//  Bakes a model straight from a file or pipe, a batch
+//  of faces at a time.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "StreamingBake.h"
+
+// include the C++ standard libraries we want
+#include <thread>
+
+// local includes
+#include "AttributedObject.h"
+#include "ObjectParser.h"
+#include "TextureBaker.h"
+
+// bakes the OBJ text read from an open file (or pipe, or stdin) to
+// <outputDirectory>/<fileName>_<channel>.ppm (or .png), counting the faces
+// returns false if the input is malformed (setting inputValid to false),
+// the parameters are invalid or any map could not be written
+bool BakeStream(FILE *input, const BakeParameters &bakeParameters,
+                const std::string &outputDirectory, const std::string &fileName,
+                size_t &faceCount, bool &inputValid)
+    { // BakeStream()
+    faceCount = 0;
+    inputValid = true;
+
+    // two batches: one being parsed while the other is baked
+    AttributedObject batches[2];
+    TextureBaker textureBaker(&batches[0], &bakeParameters);
+    if (!textureBaker.BeginBake())
+        return false;
+
+    ObjectStreamParser parser(input);
+    bool parsed = parser.NextBatch(STREAM_BATCH_FACES, batches[0]);
+    std::thread bakeThread;
+    for (int current = 0; parsed && !batches[current].faceTexCoords.empty(); current = 1 - current)
+        { // per batch
+        // the previous batch must be finished before we hand the baker this one,
+        // and before the parser reuses the previous batch's arrays
+        if (bakeThread.joinable())
+            bakeThread.join();
+
+        textureBaker.attributedObject = &batches[current];
+        bakeThread = std::thread([&textureBaker]() { textureBaker.BakeFaces(); });
+
+        // parse the next batch while this one bakes
+        parsed = parser.NextBatch(STREAM_BATCH_FACES, batches[1 - current]);
+        } // per batch
+    if (bakeThread.joinable())
+        bakeThread.join();
+
+    faceCount = parser.faceCount;
+    inputValid = parsed;
+    if (!parsed)
+        return false;
+    return textureBaker.WriteMaps(outputDirectory, fileName);
+    } // BakeStream()
@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  StreamingBake.h
+//  ------------------------
+//
+//  Bakes a model straight from a file or pipe without
+//  ever holding the whole mesh: faces are parsed in
+//  batches, and each batch is rasterized into the maps
+//  on a second thread while the next is being parsed.
+//
+//  Peak memory is the maps, the colour, normal and
+//  texture coordinate pools, and two batches, however
+//  many faces the model has.  The maps come out as
+//  they would from a full read, since each batch is
+//  drawn over the last in file order.
+//
+///////////////////////////////////////////////////
+
+// include guard for StreamingBake
+#ifndef _STREAMING_BAKE_H
+#define _STREAMING_BAKE_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "BakeParameters.h"
+
+// the number of faces in each batch
+#define STREAM_BATCH_FACES (1 << 17)
+
+// bakes the OBJ text read from an open file (or pipe, or stdin) to
+// <outputDirectory>/<fileName>_<channel>.ppm (or .png), counting the faces
+// returns false if the input is malformed (setting inputValid to false),
+// the parameters are invalid or any map could not be written
+bool BakeStream(FILE *input, const BakeParameters &bakeParameters,
+                const std::string &outputDirectory, const std::string &fileName,
+                size_t &faceCount, bool &inputValid);
+
+// end of include guard for StreamingBake
+#endif
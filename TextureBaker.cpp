@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  TextureBaker.cpp
+//  ------------------------
+//
+//  Bakes per-vertex attributes of an AttributedObject
+//  into texture maps laid out by its texture coordinates.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "TextureBaker.h"
+
+// and the other parts of the bake
+#include "ImageWriter.h"
+#include "TriangleBins.h"
+#include "WorkStealing.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+
+// constructor
+TextureBaker::TextureBaker(const AttributedObject *newAttributedObject, const BakeParameters *newBakeParameters)
+    : attributedObject(newAttributedObject), bakeParameters(newBakeParameters)
+    { // TextureBaker()
+    } // TextureBaker()
+
+// the number of bytes a bake with the current parameters will allocate
+size_t TextureBaker::RequiredBytes() const
+    { // RequiredBytes()
+    int width = bakeParameters->width;
+    int height = bakeParameters->height;
+    int threads = (bakeParameters->threads > 0) ? bakeParameters->threads : DefaultThreadCount();
+    size_t nTriangles = attributedObject->faceTexCoords.size() / 3;
+    return Image<VisibilityTexel>::AllocationBytes(BAKE_TILE_SIZE, BAKE_TILE_SIZE) * threads
+         + Image<RGB8>::AllocationBytes(width, height) * bakeParameters->channels.size()
+         + TriangleBins::RequiredBytes(*attributedObject, width, height, BAKE_TILE_SIZE)
+         + sizeof(AttributePlane) * nTriangles * bakeParameters->channels.size();
+    } // RequiredBytes()
+
+// returns the file name suffix for a channel
+const char *TextureBaker::ChannelName(BakeChannel channel)
+    { // ChannelName()
+    switch (channel)
+        { // switch on channel
+        case BAKE_CHANNEL_TEXTURE:
+            return "texture";
+        case BAKE_CHANNEL_NORMAL:
+            return "normal";
+        } // switch on channel
+    return "unknown";
+    } // ChannelName()
+
+// the RGB value (in the unit interval) of one channel at a face corner
+Cartesian3 TextureBaker::CornerValue(BakeChannel channel, unsigned int corner) const
+    { // CornerValue()
+    const AttributedObject &object = *attributedObject;
+    switch (channel)
+        { // switch on channel
+        case BAKE_CHANNEL_TEXTURE:
+            // the vertex colours are already in the unit interval
+            return object.colours[object.faceColours[corner]];
+        case BAKE_CHANNEL_NORMAL:
+            // Since normal is in the range -1 to 1 we map it
+            // to the unit interval, so -1 = 0 and 1 = full intensity
+            return Cartesian3(0.5, 0.5, 0.5) + object.normals[object.faceNormals[corner]] * 0.5;
+        } // switch on channel
+    return Cartesian3();
+    } // CornerValue()
+
+// sets up the plane of every channel over every triangle
+void TextureBaker::SetupPlanes(const TriangleBins &bins, std::vector<AttributePlane> &planes) const
+    { // SetupPlanes()
+    const std::vector<BakeChannel> &channels = bakeParameters->channels;
+    int nTriangles = (int) bins.triangles.size();
+    planes.resize((size_t) nTriangles * channels.size());
+
+    // triangles are set up in blocks, shared out between the threads
+    const int blockSize = 4096;
+    int threads = (bakeParameters->threads > 0) ? bakeParameters->threads : DefaultThreadCount();
+    RunWorkStealing((nTriangles + blockSize - 1) / blockSize, threads, [&](int, int block)
+        { // per block
+        int last = std::min(nTriangles, (block + 1) * blockSize);
+        for (int face = block * blockSize; face < last; face++)
+            { // per face
+            const UVTriangle &triangle = bins.triangles[face];
+
+            // the two edges out of corner 0, and the determinant of the 2x2 system
+            float x1 = triangle.x[1] - triangle.x[0], y1 = triangle.y[1] - triangle.y[0];
+            float x2 = triangle.x[2] - triangle.x[0], y2 = triangle.y[2] - triangle.y[0];
+            float determinant = x1 * y2 - y1 * x2;
+            // degenerate triangles are never rasterized, so any plane will do
+            float inverse = (determinant != 0.0f) ? 1.0f / determinant : 0.0f;
+
+            for (size_t channel = 0; channel < channels.size(); channel++)
+                { // per channel
+                Cartesian3 value0 = CornerValue(channels[channel], face * 3);
+                Cartesian3 delta1 = CornerValue(channels[channel], face * 3 + 1) - value0;
+                Cartesian3 delta2 = CornerValue(channels[channel], face * 3 + 2) - value0;
+
+                // solve value(corner k) = value0 + du * xk + dv * yk for k = 1, 2
+                AttributePlane &plane = planes[(size_t) face * channels.size() + channel];
+                for (int component = 0; component < 3; component++)
+                    { // per component
+                    plane.value[component] = value0[component];
+                    plane.du[component] = (delta1[component] * y2 - delta2[component] * y1) * inverse;
+                    plane.dv[component] = (delta2[component] * x1 - delta1[component] * x2) * inverse;
+                    } // per component
+                } // per channel
+            } // per face
+        }); // per block
+    } // SetupPlanes()
+
+// resolves every channel for the tile held in a visibility buffer
+void TextureBaker::ResolveTile(const VisibilityBuffer &visibility, const TriangleBins &bins,
+                               const std::vector<AttributePlane> &planes, std::vector<Image<RGB8>> &maps) const
+    { // ResolveTile()
+    size_t nChannels = bakeParameters->channels.size();
+    std::vector<float> values(nChannels * 3);
+
+    for (int y = 0; y < visibility.activeHeight; y++)
+        { // per row
+        const VisibilityTexel *row = visibility.texels.Row(y);
+        int mapY = visibility.originY + y;
+        int current = NO_TRIANGLE;
+        for (int x = 0; x < visibility.activeWidth; x++)
+            { // per texel
+            int triangleID = row[x].triangleID;
+            if (triangleID == NO_TRIANGLE)
+                { // uncovered
+                current = NO_TRIANGLE;
+                continue;
+                } // uncovered
+
+            int mapX = visibility.originX + x;
+            const AttributePlane *plane = &planes[(size_t) triangleID * nChannels];
+            if (triangleID != current)
+                { // start of a run: evaluate the planes at the texel centre
+                const UVTriangle &triangle = bins.triangles[triangleID];
+                float du = mapX + 0.5f - triangle.x[0];
+                float dv = mapY + 0.5f - triangle.y[0];
+                for (size_t channel = 0; channel < nChannels; channel++)
+                    for (int component = 0; component < 3; component++)
+                        values[channel * 3 + component] = plane[channel].value[component]
+                                                        + plane[channel].du[component] * du
+                                                        + plane[channel].dv[component] * dv;
+                current = triangleID;
+                } // start of a run
+            else
+                { // rest of a run: step one texel along
+                for (size_t channel = 0; channel < nChannels; channel++)
+                    for (int component = 0; component < 3; component++)
+                        values[channel * 3 + component] += plane[channel].du[component];
+                } // rest of a run
+
+            for (size_t channel = 0; channel < nChannels; channel++)
+                maps[channel](mapX, mapY) = RGB8::FromUnit(values[channel * 3], values[channel * 3 + 1], values[channel * 3 + 2]);
+            } // per texel
+        } // per row
+    } // ResolveTile()
+
+// checks the parameters and allocates the (black) maps and the visibility buffers
+// returns false if the size is invalid or the bake would exceed the memory budget
+bool TextureBaker::BeginBake()
+    { // BeginBake()
+    int width = bakeParameters->width;
+    int height = bakeParameters->height;
+
+    // check the size before we try to allocate anything
+    if ((width < BAKE_SIZE_MIN) || (width > BAKE_SIZE_MAX) || (height < BAKE_SIZE_MIN) || (height > BAKE_SIZE_MAX))
+        { // bad size
+        std::cout << "Bake size " << width << "x" << height << " is outside "
+                  << BAKE_SIZE_MIN << "-" << BAKE_SIZE_MAX << std::endl;
+        return false;
+        } // bad size
+    size_t requiredBytes = RequiredBytes();
+    if (requiredBytes > bakeParameters->memoryBudget)
+        { // over budget
+        std::cout << "Bake of " << width << "x" << height << " needs " << (requiredBytes >> 20)
+                  << " MiB, over the budget of " << (bakeParameters->memoryBudget >> 20) << " MiB" << std::endl;
+        return false;
+        } // over budget
+
+    // one map per channel, black where no triangle covers the texel
+    maps.clear();
+    maps.reserve(bakeParameters->channels.size());
+    for (size_t channel = 0; channel < bakeParameters->channels.size(); channel++)
+        maps.emplace_back(width, height);
+
+    // each thread reuses one tile-sized visibility buffer
+    int threads = (bakeParameters->threads > 0) ? bakeParameters->threads : DefaultThreadCount();
+    visibility.clear();
+    visibility.reserve(threads);
+    for (int thread = 0; thread < threads; thread++)
+        visibility.emplace_back(BAKE_TILE_SIZE, BAKE_TILE_SIZE);
+    return true;
+    } // BeginBake()
+
+// rasterizes the faces of the object into the maps, over whatever they already hold
+void TextureBaker::BakeFaces()
+    { // BakeFaces()
+    int width = bakeParameters->width;
+    int height = bakeParameters->height;
+
+    // sort the faces into tiles of the map
+    TriangleBins bins(*attributedObject, width, height, BAKE_TILE_SIZE);
+
+    // and set up the attribute planes of every triangle
+    std::vector<AttributePlane> planes;
+    SetupPlanes(bins, planes);
+
+    // every tile is rasterized and resolved by exactly one thread,
+    // so no texel is ever written by two threads
+    RunWorkStealing(bins.TileCount(), (int) visibility.size(), [&](int thread, int tile)
+        { // per tile
+        // tiles no face touches are left as they are
+        if (bins.tileStarts[tile] == bins.tileStarts[tile + 1])
+            return;
+
+        VisibilityBuffer &buffer = visibility[thread];
+        buffer.Reset((tile % bins.tilesX) * BAKE_TILE_SIZE, (tile / bins.tilesX) * BAKE_TILE_SIZE, width, height);
+
+        // rasterize the tile's triangles once, in file order
+        for (unsigned int entry = bins.tileStarts[tile]; entry < bins.tileStarts[tile + 1]; entry++)
+            { // per triangle
+            unsigned int face = bins.tileTriangles[entry];
+            buffer.DrawTriangle(face, bins.triangles[face]);
+            } // per triangle
+
+        // then resolve every channel while the tile is still in cache
+        ResolveTile(buffer, bins, planes, maps);
+        }); // per tile
+    } // BakeFaces()
+
+// writes each map to <outputDirectory>/<fileName>_<channel>.ppm (or .png)
+// returns false if any map could not be written
+bool TextureBaker::WriteMaps(const std::string &outputDirectory, const std::string &fileName) const
+    { // WriteMaps()
+    const std::vector<BakeChannel> &channels = bakeParameters->channels;
+    bool succeeded = true;
+    for (size_t channel = 0; channel < maps.size(); channel++)
+        { // per channel
+        bool png = (bakeParameters->format == BAKE_FORMAT_PNG);
+        std::string outputName = outputDirectory + "/" + fileName + "_" + ChannelName(channels[channel]) + (png ? ".png" : ".ppm");
+
+        if (!(png ? WritePNG(maps[channel], outputName) : WritePPM(maps[channel], outputName)))
+            { // write failed
+            std::cout << "Write failed for map " << outputName << std::endl;
+            succeeded = false;
+            } // write failed
+        } // per channel
+
+    return succeeded;
+    } // WriteMaps()
+
+// the baked map of a channel, or NULL if that channel was not baked
+const Image<RGB8> *TextureBaker::Map(BakeChannel channel) const
+    { // Map()
+    const std::vector<BakeChannel> &channels = bakeParameters->channels;
+    for (size_t which = 0; which < maps.size(); which++)
+        if (channels[which] == channel)
+            return &maps[which];
+    return NULL;
+    } // Map()
+
+// bakes the channels to <outputDirectory>/<fileName>_<channel>.ppm (or .png)
+// returns true on success, false if the parameters are invalid
+// or any map could not be written
+bool TextureBaker::Bake(const std::string &outputDirectory, const std::string &fileName)
+    { // Bake()
+    if (!BeginBake())
+        return false;
+    BakeFaces();
+    return WriteMaps(outputDirectory, fileName);
+    } // Bake()
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  TextureBaker.h
+//  ------------------------
+//
+//  Bakes per-vertex attributes of an AttributedObject
+//  into texture maps laid out by its texture coordinates.
+//
+//  The UV layout is cut into tiles, which are shared out
+//  between threads.  Each tile is rasterized once into a
+//  visibility buffer, then every requested channel is
+//  resolved in a single pass over its texels.
+//
+//  Channels are resolved from attribute planes set up
+//  once per triangle from the float vertex attributes,
+//  so a run of texels in one triangle is filled by
+//  adding the plane's gradient from texel to texel.
+//
+///////////////////////////////////////////////////
+
+// include guard for TextureBaker
+#ifndef _TEXTURE_BAKER_H
+#define _TEXTURE_BAKER_H
+
+#include <string>
+#include <vector>
+
+#include "AttributedObject.h"
+#include "BakeParameters.h"
+#include "Image.h"
+#include "TriangleBins.h"
+#include "VisibilityBuffer.h"
+
+// one channel's value over one triangle, as a plane in texel coordinates
+// value(x, y) = value + du * (x - x0) + dv * (y - y0), where (x0, y0) is corner 0
+struct AttributePlane
+    { // struct AttributePlane
+    float value[3];
+    float du[3], dv[3];
+    }; // struct AttributePlane
+
+class TextureBaker
+    { // class TextureBaker
+    public:
+    // the object whose attributes are baked
+    const AttributedObject *attributedObject;
+
+    // the bake parameters to use
+    const BakeParameters *bakeParameters;
+
+    // the maps being baked, one per channel
+    std::vector<Image<RGB8>> maps;
+
+    // one tile-sized visibility buffer per thread
+    std::vector<VisibilityBuffer> visibility;
+
+    // constructor
+    TextureBaker(const AttributedObject *newAttributedObject, const BakeParameters *newBakeParameters);
+
+    // bakes the channels to <outputDirectory>/<fileName>_<channel>.ppm (or .png)
+    // returns true on success, false if the parameters are invalid
+    // or any map could not be written
+    bool Bake(const std::string &outputDirectory, const std::string &fileName);
+
+    // the steps of Bake(), for callers that feed the faces in batches by
+    // pointing attributedObject at each batch in turn before BakeFaces()
+
+    // checks the parameters and allocates the (black) maps and the visibility buffers
+    // returns false if the size is invalid or the bake would exceed the memory budget
+    bool BeginBake();
+
+    // rasterizes the faces of the object into the maps, over whatever they already hold
+    void BakeFaces();
+
+    // writes each map to <outputDirectory>/<fileName>_<channel>.ppm (or .png)
+    // returns false if any map could not be written
+    bool WriteMaps(const std::string &outputDirectory, const std::string &fileName) const;
+
+    // the baked map of a channel, or NULL if that channel was not baked
+    const Image<RGB8> *Map(BakeChannel channel) const;
+
+    // the number of bytes a bake with the current parameters will allocate
+    size_t RequiredBytes() const;
+
+    // returns the file name suffix for a channel
+    static const char *ChannelName(BakeChannel channel);
+
+    // the RGB value (in the unit interval) of one channel at a face corner
+    Cartesian3 CornerValue(BakeChannel channel, unsigned int corner) const;
+
+    // sets up the plane of every channel over every triangle
+    // the planes for triangle t are planes[t * channels .. (t + 1) * channels - 1]
+    void SetupPlanes(const TriangleBins &bins, std::vector<AttributePlane> &planes) const;
+
+    // resolves every channel for the tile held in a visibility buffer
+    void ResolveTile(const VisibilityBuffer &visibility, const TriangleBins &bins,
+                     const std::vector<AttributePlane> &planes, std::vector<Image<RGB8>> &maps) const;
+    }; // class TextureBaker
+
+// end of include guard for TextureBaker
+#endif
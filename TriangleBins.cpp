@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  TriangleBins.cpp
+//  ------------------------
+//
+//  Sorts the faces of an object into fixed-size tiles
+//  of its UV layout.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "TriangleBins.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+
+// sets the tiling for a map of the given size, but bins nothing
+TriangleBins::TriangleBins(int width, int height, int newTileSize)
+    : tileSize(newTileSize),
+    tilesX((width + newTileSize - 1) / newTileSize),
+    tilesY((height + newTileSize - 1) / newTileSize)
+    { // TriangleBins()
+    } // TriangleBins()
+
+// a face's corners in texel coordinates, with v flipped so that row 0 is the top of the map
+UVTriangle TriangleBins::TexelTriangle(const AttributedObject &object, unsigned int face, int width, int height)
+    { // TexelTriangle()
+    UVTriangle triangle;
+    for (unsigned int vertex = 0; vertex < 3; vertex++)
+        { // per vertex
+        const Cartesian3 &texCoord = object.textureCoords[object.faceTexCoords[face*3+vertex]];
+        triangle.x[vertex] = texCoord.x * width;
+        triangle.y[vertex] = (1 - texCoord.y) * height;
+        } // per vertex
+    return triangle;
+    } // TexelTriangle()
+
+// the bytes that binning the object for a map of the given size
+// will allocate, found by a counting pass without binning anything
+size_t TriangleBins::RequiredBytes(const AttributedObject &object, int width, int height, int newTileSize)
+    { // RequiredBytes()
+    TriangleBins tiling(width, height, newTileSize);
+    unsigned int nTriangles = object.faceTexCoords.size() / 3;
+
+    // every (face, tile) pair is one entry of tileTriangles
+    size_t entries = 0;
+    for (unsigned int face = 0; face < nTriangles; face++)
+        { // per face
+        int minTileX, minTileY, maxTileX, maxTileY;
+        if (tiling.TileRange(TexelTriangle(object, face, width, height), minTileX, minTileY, maxTileX, maxTileY))
+            entries += (size_t) (maxTileX - minTileX + 1) * (maxTileY - minTileY + 1);
+        } // per face
+
+    // the triangles, the tile lists, and the starts plus the filling pass's cursors
+    return sizeof(UVTriangle) * nTriangles + sizeof(unsigned int) * entries
+         + sizeof(unsigned int) * (2 * (size_t) tiling.TileCount() + 1);
+    } // RequiredBytes()
+
+// bins every face of the object for a map of the given size
+TriangleBins::TriangleBins(const AttributedObject &object, int width, int height, int newTileSize)
+    : TriangleBins(width, height, newTileSize)
+    { // TriangleBins()
+    unsigned int nTriangles = object.faceTexCoords.size() / 3;
+
+    // triangle setup: scale the texture coordinates to texels
+    triangles.resize(nTriangles);
+    for (unsigned int face = 0; face < nTriangles; face++)
+        triangles[face] = TexelTriangle(object, face, width, height);
+
+    // counting pass: how many triangles land in each tile
+    // tileStarts[t+1] holds the count for tile t so the prefix sum lands in place
+    tileStarts.assign(TileCount() + 1, 0);
+    for (unsigned int face = 0; face < nTriangles; face++)
+        { // per face
+        int minTileX, minTileY, maxTileX, maxTileY;
+        if (!TileRange(triangles[face], minTileX, minTileY, maxTileX, maxTileY))
+            continue;
+        for (int tileY = minTileY; tileY <= maxTileY; tileY++)
+            for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+                tileStarts[tileY * tilesX + tileX + 1]++;
+        } // per face
+
+    // prefix sum turns the counts into start offsets
+    for (int tile = 0; tile < TileCount(); tile++)
+        tileStarts[tile + 1] += tileStarts[tile];
+
+    // filling pass: faces are visited in order, so each tile's list stays sorted
+    tileTriangles.resize(tileStarts[TileCount()]);
+    std::vector<unsigned int> next(tileStarts.begin(), tileStarts.end() - 1);
+    for (unsigned int face = 0; face < nTriangles; face++)
+        { // per face
+        int minTileX, minTileY, maxTileX, maxTileY;
+        if (!TileRange(triangles[face], minTileX, minTileY, maxTileX, maxTileY))
+            continue;
+        for (int tileY = minTileY; tileY <= maxTileY; tileY++)
+            for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+                tileTriangles[next[tileY * tilesX + tileX]++] = face;
+        } // per face
+    } // TriangleBins()
+
+// the inclusive range of tiles overlapped by a triangle's bounding box
+// returns false if the box misses the map entirely
+bool TriangleBins::TileRange(const UVTriangle &triangle, int &minTileX, int &minTileY, int &maxTileX, int &maxTileY) const
+    { // TileRange()
+    float minX = std::min({triangle.x[0], triangle.x[1], triangle.x[2]});
+    float minY = std::min({triangle.y[0], triangle.y[1], triangle.y[2]});
+    float maxX = std::max({triangle.x[0], triangle.x[1], triangle.x[2]});
+    float maxY = std::max({triangle.y[0], triangle.y[1], triangle.y[2]});
+
+    // reject boxes entirely off the map (this also catches NaNs)
+    if (!(maxX >= 0.0f) || !(maxY >= 0.0f) || !(minX < tilesX * tileSize) || !(minY < tilesY * tileSize))
+        return false;
+
+    minTileX = (int) std::max(minX, 0.0f) / tileSize;
+    minTileY = (int) std::max(minY, 0.0f) / tileSize;
+    maxTileX = std::min((int) std::min(maxX, (float) (tilesX * tileSize)) / tileSize, tilesX - 1);
+    maxTileY = std::min((int) std::min(maxY, (float) (tilesY * tileSize)) / tileSize, tilesY - 1);
+    return true;
+    } // TileRange()
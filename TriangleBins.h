@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  TriangleBins.h
+//  ------------------------
+//
+//  Sorts the faces of an object into fixed-size tiles
+//  of its UV layout, so that each tile of a baked map
+//  can be rasterized on its own by a single thread.
+//
+//  Binning is a counting pass followed by a prefix sum
+//  and a filling pass, so each tile's triangles end up
+//  contiguous and in their original (file) order.
+//
+///////////////////////////////////////////////////
+
+// include guard for TriangleBins
+#ifndef _TRIANGLE_BINS_H
+#define _TRIANGLE_BINS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "AttributedObject.h"
+
+// the corners of a face in texel coordinates of the baked map
+struct UVTriangle
+    { // struct UVTriangle
+    float x[3], y[3];
+    }; // struct UVTriangle
+
+class TriangleBins
+    { // class TriangleBins
+    public:
+    // size of a tile in texels, and the number of tiles in each direction
+    int tileSize;
+    int tilesX, tilesY;
+
+    // every face in texel coordinates, indexed by face ID
+    std::vector<UVTriangle> triangles;
+
+    // tile t holds tileTriangles[tileStarts[t]] .. tileTriangles[tileStarts[t+1]-1]
+    std::vector<unsigned int> tileStarts;
+    std::vector<unsigned int> tileTriangles;
+
+    // bins every face of the object for a map of the given size
+    TriangleBins(const AttributedObject &object, int width, int height, int newTileSize);
+
+    // number of tiles in total
+    int TileCount() const
+        { return tilesX * tilesY; }
+
+    // the bytes that binning the object for a map of the given size
+    // will allocate, found by a counting pass without binning anything
+    static size_t RequiredBytes(const AttributedObject &object, int width, int height, int newTileSize);
+
+    private:
+    // sets the tiling for a map of the given size, but bins nothing
+    TriangleBins(int width, int height, int newTileSize);
+
+    // a face's corners in texel coordinates, with v flipped so that row 0 is the top of the map
+    static UVTriangle TexelTriangle(const AttributedObject &object, unsigned int face, int width, int height);
+
+    // the inclusive range of tiles overlapped by a triangle's bounding box
+    // returns false if the box misses the map entirely
+    bool TileRange(const UVTriangle &triangle, int &minTileX, int &minTileY, int &maxTileX, int &maxTileY) const;
+    }; // class TriangleBins
+
+// end of include guard for TriangleBins
+#endif
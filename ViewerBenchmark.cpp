@@ -0,0 +1,378 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ViewerBenchmark.cpp
+//  ------------------------
+//
+//  Times the viewer's drawing without opening a
+//  window.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "ViewerBenchmark.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// QT
+#include <QDir>
+#include <QOffscreenSurface>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+// local includes
+#include "AttributedObject.h"
+#include "BakeCommand.h"
+#include "Image.h"
+#include "ImageWriter.h"
+#include "MeshCache.h"
+#include "MeshOrder.h"
+#include "RenderParameters.h"
+#include "RenderScene.h"
+
+// defaults for the options
+#define VIEWER_BENCHMARK_DEFAULT_FRAMES 360
+#define VIEWER_BENCHMARK_DEFAULT_WIDTH 1024
+#define VIEWER_BENCHMARK_DEFAULT_HEIGHT 768
+
+// the settings for one run
+struct ViewerBenchmarkSettings
+    { // struct ViewerBenchmarkSettings
+    int frames, width, height;
+    float zoomScale;
+    bool dragging;
+    // whether to read and write the model's binary cache
+    bool useCache;
+    // where to save the frames, or empty not to
+    std::string framesDirectory;
+    }; // struct ViewerBenchmarkSettings
+
+// the outcome for one model
+struct ViewerBenchmarkResult
+    { // struct ViewerBenchmarkResult
+    std::string filePath;
+    // one of the BAKE_EXIT_ codes
+    int status;
+    // what the last frame drew
+    size_t triangles;
+    int level;
+    // frame times in milliseconds, sorted
+    std::vector<float> milliseconds;
+    }; // struct ViewerBenchmarkResult
+
+// prints the usage message
+static void PrintUsage(const char *programName)
+    { // PrintUsage()
+    std::cout << "Usage: " << programName << " " << VIEWER_BENCHMARK_FLAG << " geometry... [options]" << std::endl;
+    std::cout << "  --frames count          frames per model, over one full turn (default " << VIEWER_BENCHMARK_DEFAULT_FRAMES << ")" << std::endl;
+    std::cout << "  --size width[xheight]   size of the framebuffer (default " << VIEWER_BENCHMARK_DEFAULT_WIDTH
+              << "x" << VIEWER_BENCHMARK_DEFAULT_HEIGHT << ")" << std::endl;
+    std::cout << "  --zoom scale            zoom, as set by the zoom slider (default 1)" << std::endl;
+    std::cout << "  --drag on|off           draw as if the arcball were being dragged (default off)" << std::endl;
+    std::cout << "  --cache on|off          keep a binary " << MESH_CACHE_EXTENSION << " cache beside each model (default on)" << std::endl;
+    std::cout << "  --save-frames directory write every frame there as <name>_<frame>.png" << std::endl;
+    std::cout << "  --summary file          write the result for each model as CSV" << std::endl;
+    } // PrintUsage()
+
+// the given percentile (0 to 100) of sorted times
+static float Percentile(const std::vector<float> &sorted, float percentile)
+    { // Percentile()
+    if (sorted.empty())
+        return 0.0f;
+    return sorted[std::min(sorted.size() - 1, (size_t) (percentile / 100.0f * sorted.size()))];
+    } // Percentile()
+
+// the mean of some times
+static float Mean(const std::vector<float> &times)
+    { // Mean()
+    double sum = 0.0;
+    for (size_t time = 0; time < times.size(); time++)
+        sum += times[time];
+    return times.empty() ? 0.0f : (float) (sum / times.size());
+    } // Mean()
+
+// maps a pixel buffer holding a bottom-up RGBA frame and writes it as a PNG
+static bool SaveFrame(QOpenGLBuffer &pixelBuffer, int width, int height, const std::string &fileName)
+    { // SaveFrame()
+    pixelBuffer.bind();
+    const unsigned char *pixels = (const unsigned char *) pixelBuffer.map(QOpenGLBuffer::ReadOnly);
+    bool succeeded = (pixels != NULL);
+    if (succeeded)
+        { // mapped
+        Image<RGB8> image(width, height);
+        for (int y = 0; y < height; y++)
+            { // per row
+            const unsigned char *in = pixels + (size_t) (height - 1 - y) * width * 4;
+            RGB8 *out = image.Row(y);
+            for (int x = 0; x < width; x++)
+                { // per pixel
+                out[x].r = in[x*4];
+                out[x].g = in[x*4+1];
+                out[x].b = in[x*4+2];
+                } // per pixel
+            } // per row
+        pixelBuffer.unmap();
+        succeeded = WritePNG(image, fileName);
+        } // mapped
+    pixelBuffer.release();
+
+    if (!succeeded)
+        std::cout << "Write failed for frame " << fileName << std::endl;
+    return succeeded;
+    } // SaveFrame()
+
+// the file a frame is saved to
+static std::string FrameFileName(const ViewerBenchmarkSettings &settings, const std::string &name, int frame)
+    { // FrameFileName()
+    char number[16];
+    snprintf(number, sizeof(number), "%05d", frame);
+    return settings.framesDirectory + "/" + name + "_" + number + ".png";
+    } // FrameFileName()
+
+// draws one model for the set number of frames, filling in the result
+// the context must be current
+static void BenchmarkModel(const std::string &filePath, const ViewerBenchmarkSettings &settings,
+                           ViewerBenchmarkResult &result)
+    { // BenchmarkModel()
+    result.filePath = filePath;
+    result.status = BAKE_EXIT_SUCCESS;
+    result.triangles = 0;
+    result.level = 0;
+
+    // read the model as the viewer does, faces in the order that suits drawing
+    AttributedObject object;
+    bool read = settings.useCache ? object.ReadObjectCached(filePath) : object.ReadObjectFile(filePath);
+    if (!read)
+        { // read failed
+        std::cout << "Read failed for object " << filePath << std::endl;
+        result.status = BAKE_EXIT_READ_FAILED;
+        return;
+        } // read failed
+    ReorderMesh(object, MESH_ORDER_OBJECT);
+    std::string name = BakeAssetName(filePath);
+
+    RenderParameters renderParameters;
+    renderParameters.zoomScale = settings.zoomScale;
+    renderParameters.dragging = settings.dragging;
+
+    // a framebuffer that could not be made (too big, say) would leave the
+    // scene drawing into the surface's own, so the model fails instead
+    QOpenGLFramebufferObject framebuffer(settings.width, settings.height, QOpenGLFramebufferObject::Depth);
+    if (!framebuffer.isValid() || !framebuffer.bind())
+        { // no framebuffer
+        std::cout << "Cannot make a " << settings.width << "x" << settings.height << " framebuffer for "
+                  << filePath << std::endl;
+        result.status = BAKE_EXIT_BAKE_FAILED;
+        return;
+        } // no framebuffer
+
+    // nothing is baked, so the scene draws vertex colours
+    RenderScene renderScene(&object, &renderParameters, NULL);
+    renderScene.Initialize();
+    renderScene.Resize(settings.width, settings.height);
+
+    // every level is simplified & uploaded before timing starts, so that
+    // each run draws the same thing
+    renderScene.WaitForLevels();
+    while (!renderScene.Paint(NULL))
+        ;
+    glFinish();
+
+    // two pixel buffers, so that one frame is read back while the next is drawn
+    QOpenGLBuffer pixelBuffers[2] = { QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer), QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer) };
+    bool saveFrames = !settings.framesDirectory.empty();
+    if (saveFrames)
+        for (int buffer = 0; buffer < 2; buffer++)
+            { // per buffer
+            pixelBuffers[buffer].create();
+            pixelBuffers[buffer].setUsagePattern(QOpenGLBuffer::StreamRead);
+            pixelBuffers[buffer].bind();
+            pixelBuffers[buffer].allocate(settings.width * settings.height * 4);
+            pixelBuffers[buffer].release();
+            } // per buffer
+
+    // one full turn about an axis tilted towards the viewer, so every side shows
+    const Cartesian3 axis(0.3f, 1.0f, 0.2f);
+    for (int frame = 0; frame < settings.frames; frame++)
+        { // per frame
+        renderParameters.rotationMatrix.SetRotation(axis, 2.0f * (float) M_PI * frame / settings.frames);
+
+        // a frame is timed until the GPU has finished it
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        renderScene.Paint(NULL);
+        glFinish();
+        result.milliseconds.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        if (saveFrames)
+            { // save frames
+            // start reading this frame, then write out the one before
+            pixelBuffers[frame % 2].bind();
+            glReadPixels(0, 0, settings.width, settings.height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            pixelBuffers[frame % 2].release();
+            if ((frame > 0) && !SaveFrame(pixelBuffers[(frame - 1) % 2], settings.width, settings.height,
+                                          FrameFileName(settings, name, frame - 1)))
+                result.status = BAKE_EXIT_BAKE_FAILED;
+            } // save frames
+        } // per frame
+
+    // the last frame is still in its pixel buffer
+    if (saveFrames && (settings.frames > 0) && !SaveFrame(pixelBuffers[(settings.frames - 1) % 2], settings.width,
+                                                          settings.height, FrameFileName(settings, name, settings.frames - 1)))
+        result.status = BAKE_EXIT_BAKE_FAILED;
+
+    const FrameStats &frameStats = renderScene.Stats();
+    result.triangles = frameStats.Sample(frameStats.Count() - 1).triangles;
+    result.level = frameStats.Sample(frameStats.Count() - 1).level;
+    std::sort(result.milliseconds.begin(), result.milliseconds.end());
+
+    for (int buffer = 0; buffer < 2; buffer++)
+        pixelBuffers[buffer].destroy();
+    renderScene.Destroy();
+    framebuffer.release();
+    } // BenchmarkModel()
+
+// writes the result for each model as CSV
+static bool WriteSummary(const std::string &summaryPath, const std::vector<ViewerBenchmarkResult> &results)
+    { // WriteSummary()
+    std::ofstream summary(summaryPath.c_str());
+    summary << "model,status,frames,triangles,level,mean_ms,fps,p50_ms,p90_ms,p99_ms,max_ms" << std::endl;
+    for (size_t model = 0; model < results.size(); model++)
+        { // per model
+        const ViewerBenchmarkResult &result = results[model];
+        float mean = Mean(result.milliseconds);
+        summary << CSVField(result.filePath) << "," << result.status << "," << result.milliseconds.size() << ","
+                << result.triangles << "," << result.level << "," << mean << ","
+                << ((mean > 0.0f) ? 1000.0f / mean : 0.0f) << "," << Percentile(result.milliseconds, 50.0f) << ","
+                << Percentile(result.milliseconds, 90.0f) << "," << Percentile(result.milliseconds, 99.0f) << ","
+                << Percentile(result.milliseconds, 100.0f) << std::endl;
+        } // per model
+    return summary.good();
+    } // WriteSummary()
+
+// runs the benchmark on the arguments after the program name & flag
+int ViewerBenchmark(const char *programName, int argc, char **argv)
+    { // ViewerBenchmark()
+    ViewerBenchmarkSettings settings;
+    settings.frames = VIEWER_BENCHMARK_DEFAULT_FRAMES;
+    settings.width = VIEWER_BENCHMARK_DEFAULT_WIDTH;
+    settings.height = VIEWER_BENCHMARK_DEFAULT_HEIGHT;
+    settings.zoomScale = 1.0f;
+    settings.dragging = false;
+    settings.useCache = true;
+    std::string summaryPath;
+    std::vector<std::string> filePaths;
+
+    for (int arg = 0; arg < argc; arg++)
+        { // per argument
+        std::string option = argv[arg];
+
+        // a bare argument is a model
+        if (option.compare(0, 2, "--") != 0)
+            { // model
+            filePaths.push_back(option);
+            continue;
+            } // model
+
+        // every option takes a value
+        if (arg + 1 == argc)
+            { // no value
+            std::cout << "Option " << option << " needs a value" << std::endl;
+            PrintUsage(programName);
+            return BAKE_EXIT_USAGE;
+            } // no value
+        std::string value = argv[++arg];
+
+        bool valid = true;
+        if (option == "--frames")
+            valid = ParseCount(value.c_str(), settings.frames) && (settings.frames > 0);
+        else if (option == "--size")
+            valid = ParseSize(value, settings.width, settings.height) && (settings.width > 0) && (settings.height > 0);
+        else if (option == "--zoom")
+            { // zoom
+            char *end;
+            errno = 0;
+            settings.zoomScale = strtof(value.c_str(), &end);
+            valid = (end != value.c_str()) && (*end == '\0') && (errno == 0)
+                 && (settings.zoomScale >= ZOOM_SCALE_MIN) && (settings.zoomScale <= ZOOM_SCALE_MAX);
+            } // zoom
+        else if ((option == "--drag") && ((value == "on") || (value == "off")))
+            settings.dragging = (value == "on");
+        else if ((option == "--cache") && ((value == "on") || (value == "off")))
+            settings.useCache = (value == "on");
+        else if (option == "--save-frames")
+            settings.framesDirectory = value;
+        else if (option == "--summary")
+            summaryPath = value;
+        else
+            valid = false;
+
+        if (!valid)
+            { // bad option
+            std::cout << "Bad option " << option << " " << value << std::endl;
+            PrintUsage(programName);
+            return BAKE_EXIT_USAGE;
+            } // bad option
+        } // per argument
+
+    if (filePaths.empty())
+        { // no model
+        PrintUsage(programName);
+        return BAKE_EXIT_USAGE;
+        } // no model
+
+    if (!settings.framesDirectory.empty() && !QDir().mkpath(QString::fromStdString(settings.framesDirectory)))
+        { // no directory
+        std::cout << "Cannot create frames directory " << settings.framesDirectory << std::endl;
+        return BAKE_EXIT_BAKE_FAILED;
+        } // no directory
+
+    // a context on an offscreen surface: no window is ever shown
+    QOffscreenSurface surface;
+    surface.create();
+    QOpenGLContext context;
+    if (!context.create() || !context.makeCurrent(&surface))
+        { // no context
+        std::cout << "Cannot create an OpenGL context" << std::endl;
+        return BAKE_EXIT_BAKE_FAILED;
+        } // no context
+    std::cout << "OpenGL " << (const char *) glGetString(GL_VERSION) << " on " << (const char *) glGetString(GL_RENDERER) << std::endl;
+
+    std::vector<ViewerBenchmarkResult> results(filePaths.size());
+    int status = BAKE_EXIT_SUCCESS;
+    for (size_t model = 0; model < filePaths.size(); model++)
+        { // per model
+        ViewerBenchmarkResult &result = results[model];
+        BenchmarkModel(filePaths[model], settings, result);
+        status = std::max(status, result.status);
+        if (result.milliseconds.empty())
+            continue;
+
+        float mean = Mean(result.milliseconds);
+        std::cout << filePaths[model] << ": " << result.milliseconds.size() << " frames of " << result.triangles
+                  << " triangles (level " << result.level << ") at " << settings.width << "x" << settings.height
+                  << ", " << 1000.0f / mean << " fps, mean " << mean << " ms, p50 " << Percentile(result.milliseconds, 50.0f)
+                  << " ms, p90 " << Percentile(result.milliseconds, 90.0f) << " ms, p99 " << Percentile(result.milliseconds, 99.0f)
+                  << " ms, max " << Percentile(result.milliseconds, 100.0f) << " ms" << std::endl;
+        } // per model
+
+    context.doneCurrent();
+
+    if (!summaryPath.empty() && !WriteSummary(summaryPath, results))
+        { // no summary
+        std::cout << "Write failed for summary " << summaryPath << std::endl;
+        status = std::max(status, BAKE_EXIT_BAKE_FAILED);
+        } // no summary
+
+    return status;
+    } // ViewerBenchmark()
@@ -0,0 +1,37 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  ViewerBenchmark.h
+//  ------------------------
+//
+//  Times the viewer's drawing without opening a
+//  window: each model is drawn into an offscreen
+//  framebuffer, spun through a fixed turn of the
+//  arcball for a given number of frames, and the
+//  frame rate & frame-time percentiles reported.
+//
+//  Frames may also be saved as PNG.  They are read
+//  back through a pair of pixel buffers, so reading
+//  one frame overlaps drawing the next, and the PNGs
+//  are written outside the timed part of each frame.
+//
+//  Without a display, run it on Qt's offscreen
+//  platform, or on eglfs over Mesa's surfaceless
+//  EGL platform.
+//
+///////////////////////////////////////////////////
+
+// include guard for ViewerBenchmark
+#ifndef _VIEWER_BENCHMARK_H
+#define _VIEWER_BENCHMARK_H
+
+// the flag that selects the benchmark in the viewer
+#define VIEWER_BENCHMARK_FLAG "--viewer-benchmark"
+
+// runs the benchmark on the arguments after the program name & flag
+// a QGuiApplication must exist; returns the process exit status
+// (the same statuses as a bake-only run)
+int ViewerBenchmark(const char *programName, int argc, char **argv);
+
+// end of include guard for ViewerBenchmark
+#endif
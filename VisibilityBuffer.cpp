@@ -0,0 +1,359 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  VisibilityBuffer.cpp
+//  ------------------------
+//
+//  A texel-space buffer recording which triangle
+//  covers each texel of the UV layout.
+//
+//  Coverage is decided with integer edge functions on
+//  fixed-point corners, using a top-left fill rule so
+//  that texels on an edge shared by two triangles are
+//  drawn by exactly one of them.  The bounding box is
+//  walked in 8x8 blocks: blocks wholly outside an edge
+//  are skipped, blocks wholly inside every edge are
+//  filled without tests, and only the blocks an edge
+//  crosses are tested texel by texel, 8 texels at a
+//  time with AVX2 or 4 with SSE4.1 where available.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "VisibilityBuffer.h"
+
+// include the C++ standard libraries we want
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// on x86 with GCC or Clang we can pick a vector kernel at run time
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VISIBILITY_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// corners are snapped to 1/16 of a texel.  With maps of up to 32768 texels
+// and tiles of up to 64 texels, the edge functions then vary by less than
+// 2^30 across a tile, so they can be stepped in 32-bit lanes
+#define SUBTEXEL_BITS 4
+#define SUBTEXEL_SCALE (1 << SUBTEXEL_BITS)
+
+// the largest texel coordinate we will snap without overflowing
+#define SNAP_LIMIT 16777216.0f
+
+// the side of the square blocks the bounding box is classified in
+#define COVERAGE_BLOCK 8
+
+// the value of every texel before rasterizing
+static const VisibilityTexel emptyTexel = { NO_TRIANGLE };
+
+// a coverage kernel tests count (<= 64) consecutive texels of a row against
+// all three edges and returns one bit per texel that lies inside.  edges
+// holds the (biased) edge functions at the first texel, steps their change
+// from one texel to the next
+typedef uint64_t (*CoverageKernel)(const int32_t edges[3], const int32_t steps[3], int count);
+
+// mask with the low count bits set
+static inline uint64_t LowBits(int count)
+    { // LowBits()
+    return (count >= 64) ? ~(uint64_t) 0 : (((uint64_t) 1 << count) - 1);
+    } // LowBits()
+
+// index of the lowest set bit of a non-zero mask
+static inline int LowestBit(uint64_t mask)
+    { // LowestBit()
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1))
+        { mask >>= 1; bit++; }
+    return bit;
+#endif
+    } // LowestBit()
+
+// one texel at a time, for machines without a vector kernel
+static uint64_t CoverageScalar(const int32_t edges[3], const int32_t steps[3], int count)
+    { // CoverageScalar()
+    int32_t e0 = edges[0], e1 = edges[1], e2 = edges[2];
+    uint64_t mask = 0;
+    for (int texel = 0; texel < count; texel++)
+        { // per texel
+        // a texel is inside if no edge function is negative,
+        // i.e. if the sign bit of their OR is clear
+        if ((e0 | e1 | e2) >= 0)
+            mask |= (uint64_t) 1 << texel;
+        e0 += steps[0];
+        e1 += steps[1];
+        e2 += steps[2];
+        } // per texel
+    return mask;
+    } // CoverageScalar()
+
+#ifdef VISIBILITY_X86_KERNELS
+// four texels at a time
+__attribute__((target("sse4.1")))
+static uint64_t CoverageSSE4(const int32_t edges[3], const int32_t steps[3], int count)
+    { // CoverageSSE4()
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i e0 = _mm_add_epi32(_mm_set1_epi32(edges[0]), _mm_mullo_epi32(lanes, _mm_set1_epi32(steps[0])));
+    __m128i e1 = _mm_add_epi32(_mm_set1_epi32(edges[1]), _mm_mullo_epi32(lanes, _mm_set1_epi32(steps[1])));
+    __m128i e2 = _mm_add_epi32(_mm_set1_epi32(edges[2]), _mm_mullo_epi32(lanes, _mm_set1_epi32(steps[2])));
+    const __m128i step0 = _mm_set1_epi32(steps[0] * 4);
+    const __m128i step1 = _mm_set1_epi32(steps[1] * 4);
+    const __m128i step2 = _mm_set1_epi32(steps[2] * 4);
+
+    uint64_t mask = 0;
+    for (int texel = 0; texel < count; texel += 4)
+        { // per four texels
+        // the sign bits of the OR mark texels outside at least one edge
+        __m128i any = _mm_or_si128(_mm_or_si128(e0, e1), e2);
+        unsigned int outside = _mm_movemask_ps(_mm_castsi128_ps(any));
+        mask |= (uint64_t) (~outside & 0xF) << texel;
+        e0 = _mm_add_epi32(e0, step0);
+        e1 = _mm_add_epi32(e1, step1);
+        e2 = _mm_add_epi32(e2, step2);
+        } // per four texels
+    return mask & LowBits(count);
+    } // CoverageSSE4()
+
+// eight texels at a time
+__attribute__((target("avx2")))
+static uint64_t CoverageAVX2(const int32_t edges[3], const int32_t steps[3], int count)
+    { // CoverageAVX2()
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i e0 = _mm256_add_epi32(_mm256_set1_epi32(edges[0]), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(steps[0])));
+    __m256i e1 = _mm256_add_epi32(_mm256_set1_epi32(edges[1]), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(steps[1])));
+    __m256i e2 = _mm256_add_epi32(_mm256_set1_epi32(edges[2]), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(steps[2])));
+    const __m256i step0 = _mm256_set1_epi32(steps[0] * 8);
+    const __m256i step1 = _mm256_set1_epi32(steps[1] * 8);
+    const __m256i step2 = _mm256_set1_epi32(steps[2] * 8);
+
+    uint64_t mask = 0;
+    for (int texel = 0; texel < count; texel += 8)
+        { // per eight texels
+        // the sign bits of the OR mark texels outside at least one edge
+        __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), e2);
+        unsigned int outside = _mm256_movemask_ps(_mm256_castsi256_ps(any));
+        mask |= (uint64_t) (~outside & 0xFF) << texel;
+        e0 = _mm256_add_epi32(e0, step0);
+        e1 = _mm256_add_epi32(e1, step1);
+        e2 = _mm256_add_epi32(e2, step2);
+        } // per eight texels
+    return mask & LowBits(count);
+    } // CoverageAVX2()
+#endif
+
+// picks the widest kernel the processor supports
+static CoverageKernel SelectCoverageKernel()
+    { // SelectCoverageKernel()
+#ifdef VISIBILITY_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return CoverageAVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return CoverageSSE4;
+#endif
+    return CoverageScalar;
+    } // SelectCoverageKernel()
+
+// chosen once, at start-up
+static const CoverageKernel coverageKernel = SelectCoverageKernel();
+
+// constructor allocates a tile-sized buffer
+VisibilityBuffer::VisibilityBuffer(int tileWidth, int tileHeight)
+    : texels(tileWidth, tileHeight, emptyTexel),
+    originX(0), originY(0),
+    activeWidth(tileWidth), activeHeight(tileHeight)
+    { // VisibilityBuffer()
+    } // VisibilityBuffer()
+
+// empties the buffer and moves it to a new tile of a map
+void VisibilityBuffer::Reset(int newOriginX, int newOriginY, int mapWidth, int mapHeight)
+    { // Reset()
+    originX = newOriginX;
+    originY = newOriginY;
+    activeWidth = std::min(texels.width, mapWidth - originX);
+    activeHeight = std::min(texels.height, mapHeight - originY);
+
+    for (int y = 0; y < activeHeight; y++)
+        std::fill(texels.Row(y), texels.Row(y) + activeWidth, emptyTexel);
+    } // Reset()
+
+// rasterizes one triangle given in texel coordinates of the map
+void VisibilityBuffer::DrawTriangle(int triangleID, const UVTriangle &triangle)
+    { // DrawTriangle()
+    // reject corners too far off the map to snap safely
+    for (int vertex = 0; vertex < 3; vertex++)
+        if (!(std::fabs(triangle.x[vertex]) < SNAP_LIMIT) || !(std::fabs(triangle.y[vertex]) < SNAP_LIMIT))
+            return;
+
+    // snap the corners to fixed point, relative to the tile origin
+    // snapping the absolute position keeps shared corners identical in every tile
+    int64_t fx[3], fy[3];
+    for (int vertex = 0; vertex < 3; vertex++)
+        { // per vertex
+        fx[vertex] = (int64_t) std::llrint(triangle.x[vertex] * SUBTEXEL_SCALE) - (int64_t) originX * SUBTEXEL_SCALE;
+        fy[vertex] = (int64_t) std::llrint(triangle.y[vertex] * SUBTEXEL_SCALE) - (int64_t) originY * SUBTEXEL_SCALE;
+        } // per vertex
+
+    // twice the signed area: zero means the snapped triangle covers nothing
+    int64_t area = (fx[1] - fx[0]) * (fy[2] - fy[0]) - (fy[1] - fy[0]) * (fx[2] - fx[0]);
+    if (area == 0)
+        return;
+
+    // UV layouts may wind either way, so visit the corners in the order
+    // that makes the area positive: inside is then where every edge function is
+    int order[3] = { 0, 1, 2 };
+    if (area < 0)
+        std::swap(order[1], order[2]);
+
+    // bounding box of the texel centres, clipped to the tile
+    int64_t boxMinX = std::min({fx[0], fx[1], fx[2]}) >> SUBTEXEL_BITS;
+    int64_t boxMinY = std::min({fy[0], fy[1], fy[2]}) >> SUBTEXEL_BITS;
+    int64_t boxMaxX = std::max({fx[0], fx[1], fx[2]}) >> SUBTEXEL_BITS;
+    int64_t boxMaxY = std::max({fy[0], fy[1], fy[2]}) >> SUBTEXEL_BITS;
+    int minX = (int) std::max(boxMinX, (int64_t) 0);
+    int minY = (int) std::max(boxMinY, (int64_t) 0);
+    int maxX = (int) std::min(boxMaxX, (int64_t) activeWidth - 1);
+    int maxY = (int) std::min(boxMaxY, (int64_t) activeHeight - 1);
+    if ((minX > maxX) || (minY > maxY))
+        return;
+
+    // edge setup: edge k runs from corner order[k] to corner order[k+1]
+    // E(p) = (x1 - x0)(py - y0) - (y1 - y0)(px - x0), evaluated at texel centres
+    int64_t boxEdges[3];
+    int64_t stepsX[3];
+    int64_t stepsY[3];
+    bool wide = false;
+    for (int edge = 0; edge < 3; edge++)
+        { // per edge
+        int from = order[edge], to = order[(edge + 1) % 3];
+        int64_t dx = fx[to] - fx[from];
+        int64_t dy = fy[to] - fy[from];
+
+        // the centre of texel (minX, minY)
+        int64_t px = ((int64_t) minX << SUBTEXEL_BITS) + SUBTEXEL_SCALE / 2;
+        int64_t py = ((int64_t) minY << SUBTEXEL_BITS) + SUBTEXEL_SCALE / 2;
+        int64_t value = dx * (py - fy[from]) - dy * (px - fx[from]);
+
+        // top-left fill rule: texels exactly on an edge belong to the triangle
+        // only if it is a left edge (going up the map) or a top edge (horizontal,
+        // going right).  Otherwise we bias by one so that E == 0 tests outside
+        bool topLeft = (dy < 0) || ((dy == 0) && (dx > 0));
+        if (!topLeft)
+            value -= 1;
+
+        int64_t stepX = -dy * SUBTEXEL_SCALE;
+        int64_t stepY = dx * SUBTEXEL_SCALE;
+
+        // the extremes of the edge function over the box lie at its corners
+        int64_t spanX = stepX * (maxX - minX), spanY = stepY * (maxY - minY);
+        int64_t lowest = value + std::min(spanX, (int64_t) 0) + std::min(spanY, (int64_t) 0);
+        int64_t highest = value + std::max(spanX, (int64_t) 0) + std::max(spanY, (int64_t) 0);
+
+        // if the whole box is outside this edge, the triangle misses the tile
+        if (highest < 0)
+            return;
+
+        // if the whole box is inside, the edge needs no testing at all
+        if (lowest >= 0)
+            { // trivially inside
+            boxEdges[edge] = 0;
+            stepsX[edge] = 0;
+            stepsY[edge] = 0;
+            continue;
+            } // trivially inside
+
+        // otherwise we step it, checking that 32 bits (plus a lane overrun) suffice
+        int64_t overrun = 8 * (stepX < 0 ? -stepX : stepX);
+        if ((lowest - overrun < INT32_MIN) || (highest + overrun > INT32_MAX))
+            wide = true;
+        boxEdges[edge] = value;
+        stepsX[edge] = stepX;
+        stepsY[edge] = stepY;
+        } // per edge
+
+    // the kernels step in 32 bits
+    int32_t kernelSteps[3];
+    for (int edge = 0; edge < 3; edge++)
+        kernelSteps[edge] = (int32_t) stepsX[edge];
+
+    // blocks are aligned to the tile, and clipped to the bounding box
+    for (int blockY = minY & ~(COVERAGE_BLOCK - 1); blockY <= maxY; blockY += COVERAGE_BLOCK)
+        { // per row of blocks
+        int y0 = std::max(blockY, minY), y1 = std::min(blockY + COVERAGE_BLOCK - 1, maxY);
+        for (int blockX = minX & ~(COVERAGE_BLOCK - 1); blockX <= maxX; blockX += COVERAGE_BLOCK)
+            { // per block
+            int x0 = std::max(blockX, minX), x1 = std::min(blockX + COVERAGE_BLOCK - 1, maxX);
+            int count = x1 - x0 + 1;
+
+            // classify the block against each edge from the extremes at its corners
+            int64_t cornerEdges[3];
+            bool outside = false, inside = true;
+            for (int edge = 0; edge < 3; edge++)
+                { // per edge
+                cornerEdges[edge] = boxEdges[edge] + stepsX[edge] * (x0 - minX) + stepsY[edge] * (y0 - minY);
+                int64_t spanX = stepsX[edge] * (x1 - x0), spanY = stepsY[edge] * (y1 - y0);
+                if (cornerEdges[edge] + std::max(spanX, (int64_t) 0) + std::max(spanY, (int64_t) 0) < 0)
+                    outside = true;
+                if (cornerEdges[edge] + std::min(spanX, (int64_t) 0) + std::min(spanY, (int64_t) 0) < 0)
+                    inside = false;
+                } // per edge
+
+            // wholly outside an edge: nothing to draw
+            if (outside)
+                continue;
+
+            // wholly inside every edge: fill without testing
+            if (inside)
+                { // trivial accept
+                for (int v = y0; v <= y1; v++)
+                    { // per row
+                    VisibilityTexel *row = texels.Row(v);
+                    for (int u = x0; u <= x1; u++)
+                        row[u].triangleID = triangleID;
+                    } // per row
+                continue;
+                } // trivial accept
+
+            // crossed by an edge: test each texel
+            for (int v = y0; v <= y1; v++)
+                { // per row
+                uint64_t mask = 0;
+                if (!wide)
+                    { // 32-bit kernel
+                    int32_t edges[3];
+                    for (int edge = 0; edge < 3; edge++)
+                        edges[edge] = (int32_t) cornerEdges[edge];
+                    mask = coverageKernel(edges, kernelSteps, count);
+                    } // 32-bit kernel
+                else
+                    { // 64-bit fallback for triangles far outside the map
+                    for (int texel = 0; texel < count; texel++)
+                        { // per texel
+                        bool covered = true;
+                        for (int edge = 0; edge < 3; edge++)
+                            if (cornerEdges[edge] + stepsX[edge] * texel < 0)
+                                covered = false;
+                        if (covered)
+                            mask |= (uint64_t) 1 << texel;
+                        } // per texel
+                    } // 64-bit fallback
+
+                // now store the covered texels
+                VisibilityTexel *row = texels.Row(v);
+                while (mask)
+                    { // per covered texel
+                    int u = x0 + LowestBit(mask);
+                    mask &= mask - 1;
+                    row[u].triangleID = triangleID;
+                    } // per covered texel
+
+                for (int edge = 0; edge < 3; edge++)
+                    cornerEdges[edge] += stepsY[edge];
+                } // per row
+            } // per block
+        } // per row of blocks
+    } // DrawTriangle()
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  VisibilityBuffer.h
+//  ------------------------
+//
+//  A texel-space buffer recording which triangle
+//  covers each texel of one tile of the UV layout.
+//
+//  Each tile is rasterized into this buffer once, and
+//  every baked channel (colour, normal, &c.) is then
+//  resolved from it without touching the rasterizer again,
+//  using the attribute planes of the triangle at each texel.
+//  The buffer is reused from one tile to the next.
+//
+///////////////////////////////////////////////////
+
+// include guard for VisibilityBuffer
+#ifndef _VISIBILITY_BUFFER_H
+#define _VISIBILITY_BUFFER_H
+
+// the triangles we rasterize
+#include "TriangleBins.h"
+// the storage for the texels
+#include "Image.h"
+
+// triangle ID used for texels that no triangle covers
+#define NO_TRIANGLE -1
+
+// one texel of the buffer
+struct VisibilityTexel
+    { // struct VisibilityTexel
+    int triangleID;
+    }; // struct VisibilityTexel
+
+class VisibilityBuffer
+    { // class VisibilityBuffer
+    public:
+    // the texels, row-major from the top of the tile
+    Image<VisibilityTexel> texels;
+
+    // the texel of the map that texels(0, 0) corresponds to
+    int originX, originY;
+
+    // the part of the buffer that lies inside the map
+    // (tiles on the right and bottom edges may be cut short)
+    int activeWidth, activeHeight;
+
+    // constructor allocates a tile-sized buffer
+    VisibilityBuffer(int tileWidth, int tileHeight);
+
+    // empties the buffer and moves it to a new tile of a map
+    void Reset(int newOriginX, int newOriginY, int mapWidth, int mapHeight);
+
+    // rasterizes one triangle given in texel coordinates of the map
+    void DrawTriangle(int triangleID, const UVTriangle &triangle);
+    }; // class VisibilityBuffer
+
+// end of include guard for VisibilityBuffer
+#endif
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  WeldedMesh.cpp
+//  ------------------------
+//
+//  Collapses the separate index streams of an object
+//  into one interleaved vertex buffer & index buffer.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "WeldedMesh.h"
+
+// include the C++ standard libraries we want
+#include <stdint.h>
+
+// marks an unused slot of the hash table
+#define WELD_EMPTY 0xFFFFFFFFu
+
+// the four attribute indices of a corner
+struct WeldKey
+    { // struct WeldKey
+    unsigned int id[4];
+    }; // struct WeldKey
+
+// mixes the four indices into a well spread hash
+static inline uint64_t HashKey(const WeldKey &key)
+    { // HashKey()
+    uint64_t hash = (((uint64_t) key.id[0] << 32) | key.id[1]) * 0x9E3779B97F4A7C15ull;
+    hash ^= (((uint64_t) key.id[2] << 32) | key.id[3]) * 0xC2B2AE3D27D4EB4Full;
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    return hash ^ (hash >> 32);
+    } // HashKey()
+
+// copies one attribute into a vertex, or zeroes it if the object has none
+static inline void CopyAttribute(const std::vector<Cartesian3> &values, unsigned int id, float *out, int components)
+    { // CopyAttribute()
+    Cartesian3 value = (id < values.size()) ? values[id] : Cartesian3(0.0, 0.0, 0.0);
+    out[0] = value.x;
+    out[1] = value.y;
+    if (components == 3)
+        out[2] = value.z;
+    } // CopyAttribute()
+
+// welds every corner of the object, replacing anything already here
+void WeldedMesh::Weld(const AttributedObject &object)
+    { // Weld()
+    size_t corners = object.faceVertices.size();
+    vertices.clear();
+    indices.resize(corners);
+
+    // a table at most half full keeps the probes short
+    size_t tableSize = 16;
+    while (tableSize < 2 * corners)
+        tableSize *= 2;
+    std::vector<unsigned int> table(tableSize, WELD_EMPTY);
+    std::vector<WeldKey> keys;
+
+    for (size_t corner = 0; corner < corners; corner++)
+        { // per corner
+        WeldKey key = {{ object.faceVertices[corner],
+                         (corner < object.faceColours.size()) ? object.faceColours[corner] : 0u,
+                         (corner < object.faceNormals.size()) ? object.faceNormals[corner] : 0u,
+                         (corner < object.faceTexCoords.size()) ? object.faceTexCoords[corner] : 0u }};
+
+        // linear probing until we find the key or an empty slot
+        size_t slot = HashKey(key) & (tableSize - 1);
+        while (table[slot] != WELD_EMPTY)
+            { // probe
+            const WeldKey &found = keys[table[slot]];
+            if ((found.id[0] == key.id[0]) && (found.id[1] == key.id[1])
+                && (found.id[2] == key.id[2]) && (found.id[3] == key.id[3]))
+                break;
+            slot = (slot + 1) & (tableSize - 1);
+            } // probe
+
+        if (table[slot] == WELD_EMPTY)
+            { // new vertex
+            table[slot] = (unsigned int) keys.size();
+            keys.push_back(key);
+            WeldedVertex vertex;
+            CopyAttribute(object.vertices, key.id[0], vertex.position, 3);
+            CopyAttribute(object.colours, key.id[1], vertex.colour, 3);
+            CopyAttribute(object.normals, key.id[2], vertex.normal, 3);
+            CopyAttribute(object.textureCoords, key.id[3], vertex.texCoord, 2);
+            vertices.push_back(vertex);
+            } // new vertex
+        indices[corner] = table[slot];
+        } // per corner
+
+    // the vector grew by doubling, so give back the slack
+    vertices.shrink_to_fit();
+    } // Weld()
+
+// corners per welded vertex
+float WeldedMesh::DedupRatio() const
+    { // DedupRatio()
+    if (vertices.empty())
+        return 1.0f;
+    return (float) indices.size() / vertices.size();
+    } // DedupRatio()
+
+// bytes held by the welded vertices & indices
+size_t WeldedMesh::Bytes() const
+    { // Bytes()
+    return vertices.size() * sizeof(WeldedVertex) + indices.size() * sizeof(unsigned int);
+    } // Bytes()
+
+// bytes the object holds for the same attributes & index streams
+size_t WeldedMesh::ObjectBytes(const AttributedObject &object)
+    { // ObjectBytes()
+    return (object.vertices.size() + object.colours.size() + object.normals.size() + object.textureCoords.size()) * sizeof(Cartesian3)
+        + (object.faceVertices.size() + object.faceColours.size() + object.faceNormals.size() + object.faceTexCoords.size()) * sizeof(unsigned int);
+    } // ObjectBytes()
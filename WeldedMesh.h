@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  WeldedMesh.h
+//  ------------------------
+//
+//  An AttributedObject keeps separate index streams
+//  for positions, colours, normals & texture coords.
+//  Welding collapses every distinct combination of the
+//  four indices into a single interleaved vertex, so
+//  that the mesh can be drawn (or walked) through one
+//  index buffer.
+//
+//  Corners are matched on their indices, not their
+//  values, through an open-addressing hash table, so a
+//  mesh is welded in one linear pass.
+//
+///////////////////////////////////////////////////
+
+// include guard for WeldedMesh
+#ifndef _WELDED_MESH_H
+#define _WELDED_MESH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "AttributedObject.h"
+
+// one vertex of a welded mesh, with its attributes side by side
+struct WeldedVertex
+    { // struct WeldedVertex
+    float position[3];
+    float colour[3];
+    float normal[3];
+    float texCoord[2];
+    }; // struct WeldedVertex
+
+class WeldedMesh
+    { // class WeldedMesh
+    public:
+    // one entry per distinct combination of attributes
+    std::vector<WeldedVertex> vertices;
+
+    // three per triangle, into vertices
+    std::vector<unsigned int> indices;
+
+    // welds every corner of the object, replacing anything already here
+    void Weld(const AttributedObject &object);
+
+    // corners per welded vertex: 1 means nothing was shared,
+    // 6 is typical of a smooth closed mesh
+    float DedupRatio() const;
+
+    // bytes held by the welded vertices & indices
+    size_t Bytes() const;
+
+    // bytes the object holds for the same attributes & index streams
+    static size_t ObjectBytes(const AttributedObject &object);
+    }; // class WeldedMesh
+
+// end of include guard for WeldedMesh
+#endif
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  WorkStealing.cpp
+//  ------------------------
+//
+//  Runs a fixed set of independent tasks on a number
+//  of threads with per-thread work-stealing queues.
+//
+///////////////////////////////////////////////////
+
+// include the header file
+#include "WorkStealing.h"
+
+// include the C++ standard libraries we want
+#include <thread>
+#include <vector>
+
+// adds a task for the owner
+void WorkStealingQueue::Push(int task)
+    { // Push()
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(task);
+    } // Push()
+
+// takes the owner's next task, returns false if empty
+bool WorkStealingQueue::Pop(int &task)
+    { // Pop()
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty())
+        return false;
+    task = tasks.back();
+    tasks.pop_back();
+    return true;
+    } // Pop()
+
+// takes a task from the other end, returns false if empty
+bool WorkStealingQueue::Steal(int &task)
+    { // Steal()
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty())
+        return false;
+    task = tasks.front();
+    tasks.pop_front();
+    return true;
+    } // Steal()
+
+// returns the number of threads to use when the caller asks for 0 (i.e. automatic)
+int DefaultThreadCount()
+    { // DefaultThreadCount()
+    // hardware_concurrency() may return 0 if it can't tell
+    unsigned int cores = std::thread::hardware_concurrency();
+    return (cores == 0) ? 1 : (int) cores;
+    } // DefaultThreadCount()
+
+// calls task(thread, index) once for every index in [0, taskCount)
+// using threadCount threads (including the calling thread)
+// and returns once every task has finished
+void RunWorkStealing(int taskCount, int threadCount,
+                     const std::function<void(int thread, int task)> &task)
+    { // RunWorkStealing()
+    if (threadCount < 1)
+        threadCount = 1;
+    if (threadCount > taskCount)
+        threadCount = (taskCount > 0) ? taskCount : 1;
+
+    // give each thread a contiguous run of tasks so that neighbouring
+    // tasks (which usually share data) stay on the same core.  They are
+    // pushed in reverse so the owner pops them in ascending order.
+    std::vector<WorkStealingQueue> queues(threadCount);
+    for (int thread = 0; thread < threadCount; thread++)
+        { // per thread
+        int first = (int) ((long long) taskCount * thread / threadCount);
+        int last = (int) ((long long) taskCount * (thread + 1) / threadCount);
+        for (int index = last - 1; index >= first; index--)
+            queues[thread].Push(index);
+        } // per thread
+
+    // the body of every worker: drain our own queue, then steal
+    // no tasks are ever added, so once every queue is empty we are done
+    auto worker = [&](int thread)
+        { // worker
+        int index;
+        while (true)
+            { // until no work is left
+            if (queues[thread].Pop(index))
+                { // own task
+                task(thread, index);
+                continue;
+                } // own task
+
+            // look for a victim, starting with our neighbour
+            bool stole = false;
+            for (int offset = 1; offset < threadCount && !stole; offset++)
+                stole = queues[(thread + offset) % threadCount].Steal(index);
+            if (!stole)
+                break;
+            task(thread, index);
+            } // until no work is left
+        }; // worker
+
+    // the calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < threadCount; thread++)
+        threads.push_back(std::thread(worker, thread));
+    worker(0);
+    for (size_t thread = 0; thread < threads.size(); thread++)
+        threads[thread].join();
+    } // RunWorkStealing()
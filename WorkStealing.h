@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////
+//
+//  ------------------------
+//  WorkStealing.h
+//  ------------------------
+//
+//  Runs a fixed set of independent tasks on a number
+//  of threads.  Each thread starts with a contiguous
+//  run of tasks in its own queue and, once that runs
+//  dry, steals from the far end of the other queues.
+//
+///////////////////////////////////////////////////
+
+// include guard for WorkStealing
+#ifndef _WORK_STEALING_H
+#define _WORK_STEALING_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// a double-ended queue of task indices
+// the owner takes from the back, thieves take from the front
+class WorkStealingQueue
+    { // class WorkStealingQueue
+    public:
+    // adds a task for the owner
+    void Push(int task);
+
+    // takes the owner's next task, returns false if empty
+    bool Pop(int &task);
+
+    // takes a task from the other end, returns false if empty
+    bool Steal(int &task);
+
+    private:
+    std::mutex mutex;
+    std::deque<int> tasks;
+    }; // class WorkStealingQueue
+
+// returns the number of threads to use when the caller asks for 0 (i.e. automatic)
+int DefaultThreadCount();
+
+// calls task(thread, index) once for every index in [0, taskCount)
+// using threadCount threads (including the calling thread)
+// and returns once every task has finished
+void RunWorkStealing(int taskCount, int threadCount,
+                     const std::function<void(int thread, int task)> &task);
+
+// end of include guard for WorkStealing
+#endif
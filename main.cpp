@@ -18,6 +18,9 @@
 // system libraries
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 // QT
 #include <QApplication>
@@ -27,45 +30,109 @@
 #include "AttributedObject.h"
 #include "RenderParameters.h"
 #include "RenderController.h"
+#include "BakeCommand.h"
+#include "BakeParameters.h"
+#include "MeshOrder.h"
+#include "TextureBaker.h"
+#include "ViewerBenchmark.h"
+
+// prints the ways the program can be run
+static void PrintUsage(const char *programName)
+    { // PrintUsage()
+    std::cout << "Usage: " << programName << " geometry [width [height]] [--cache on|off]" << std::endl; 
+    std::cout << "   or: " << programName << " " << BAKE_ONLY_FLAG << " geometry [options]" << std::endl; 
+    std::cout << "   or: " << programName << " " << VIEWER_BENCHMARK_FLAG << " geometry [options]" << std::endl; 
+    } // PrintUsage()
 
 // main routine
 int main(int argc, char **argv)
     { // main()
+    // bake-only runs never start QT or open a window
+    if ((argc > 1) && (strcmp(argv[1], BAKE_ONLY_FLAG) == 0))
+        return BakeCommand(argv[0], argc - 2, argv + 2);
+
+    // the viewer benchmark draws offscreen, so with no display at all it
+    // runs on QT's offscreen platform unless told otherwise
+    bool benchmark = (argc > 1) && (strcmp(argv[1], VIEWER_BENCHMARK_FLAG) == 0);
+    if (benchmark && !getenv("QT_QPA_PLATFORM") && !getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY"))
+        setenv("QT_QPA_PLATFORM", "offscreen", 1);
+
     // initialize QT
     QApplication renderApp(argc, argv);
 
+    // the benchmark never opens a window
+    if (benchmark)
+        return ViewerBenchmark(argv[0], argc - 2, argv + 2);
+
+    // the cache option may come anywhere; the rest are the input file
+    // optionally followed by the size of the baked maps
+    bool useCache = true;
+    bool validCache = true;
+    std::vector<char *> arguments;
+    for (int argument = 1; argument < argc; argument++)
+        { // per argument
+        if (strcmp(argv[argument], "--cache") != 0)
+            arguments.push_back(argv[argument]);
+        else if ((argument + 1 < argc) && ((strcmp(argv[argument + 1], "on") == 0) || (strcmp(argv[argument + 1], "off") == 0)))
+            useCache = (strcmp(argv[++argument], "on") == 0);
+        else
+            { // bad cache option
+            std::cout << "Bad option --cache " << ((argument + 1 < argc) ? argv[argument + 1] : "") << std::endl;
+            validCache = false;
+            } // bad cache option
+        } // per argument
+
     // check the args to make sure there's an input file
-    if (argc != 2) 
+    if (!validCache || (arguments.size() < 1) || (arguments.size() > 3))
         { // bad arg count
         // print an error message
-        std::cout << "Usage: " << argv[0] << " geometry" << std::endl; 
+        PrintUsage(argv[0]);
         // and leave
-        return 0;
+        return validCache ? 0 : BAKE_EXIT_USAGE;
         } // bad arg count
 
+    // create some default bake parameters
+    BakeParameters bakeParameters;
+
+    // a single size gives a square map
+    bool validSize = true;
+    if (arguments.size() >= 2)
+        validSize = ParseCount(arguments[1], bakeParameters.width);
+    bakeParameters.height = bakeParameters.width;
+    if (arguments.size() == 3)
+        validSize = validSize && ParseCount(arguments[2], bakeParameters.height);
+    if (!validSize)
+        { // bad size
+        std::cout << "Bad size " << arguments[1] << ((arguments.size() == 3) ? " " : "") << ((arguments.size() == 3) ? arguments[2] : "") << std::endl;
+        PrintUsage(argv[0]);
+        return BAKE_EXIT_USAGE;
+        } // bad size
+
     //  use the argument to create a height field &c.
     AttributedObject AttributedObject;
 
-    // open the input files for the geometry & texture
-    std::ifstream geometryFile(argv[1]);
-
-    // try reading it
-    if (!(geometryFile.good()) || (!AttributedObject.ReadObjectStream(geometryFile)))
+    // try reading the geometry file, or its cache unless told not to
+    const char *geometry = arguments[0];
+    bool read = useCache ? AttributedObject.ReadObjectCached(geometry) : AttributedObject.ReadObjectFile(geometry);
+    if (!read)
         { // object read failed 
-        std::cout << "Read failed for object " << argv[1] << std::endl;
+        std::cout << "Read failed for object " << geometry << std::endl;
         return 0;
         } // object read failed
 
-    std::string filePath = argv[1];
-    int strokeIndex = filePath.find_last_of("/\\");
-
-    std::string fileName = filePath.substr(strokeIndex + 1);
-    int dotIndex = fileName.find_last_of(".");
-    fileName = fileName.substr(0, dotIndex);
+    std::string fileName = BakeAssetName(geometry);
 
     //AttributedObject.print();
-    AttributedObject.outputTexture(fileName);
-    AttributedObject.outputNormal(fileName);
+    // rasterize the UV layout once and bake both maps from it
+    TextureBaker textureBaker(&AttributedObject, &bakeParameters);
+    if (!MakeDirectory("output") || !textureBaker.Bake("output", fileName))
+        { // bake failed
+        std::cout << "Bake failed for object " << geometry << std::endl;
+        return BAKE_EXIT_BAKE_FAILED;
+        } // bake failed
+
+    // the bake is done, so the faces can go in the order that suits drawing
+    ReorderMesh(AttributedObject, MESH_ORDER_OBJECT);
 
     //std::ofstream myfile;
     //myfile.open("example.ppm");
@@ -77,7 +144,7 @@ int main(int argc, char **argv)
     RenderParameters renderParameters;
 
     // use the object & parameters to create a window
-    RenderWindow renderWindow(&AttributedObject, &renderParameters, argv[1]);
+    RenderWindow renderWindow(&AttributedObject, &renderParameters, &textureBaker, geometry);
 
     // create a controller for the window
     RenderController renderController(&AttributedObject, &renderParameters, &renderWindow);